@@ -0,0 +1,87 @@
+/*
+    DebugUtils.cppm
+
+    Module interface unit of DebugUtils.  It exports the same API as DebugUtils.hpp (except for the macros, 
+    which modules can't export, see DebugUtilsMacros.hpp).  The module is compiled once, with the value of 
+    DEBUGUTILS_ON (and DEBUGUTILS_LEVEL) that it is built with, and then imported:
+
+        import DebugUtils;
+        #include "DebugUtilsMacros.hpp"
+
+    Importing the module is cheaper than including the header in every translation unit, because the
+    compiler doesn't parse the header and the standard headers it depends on each time.
+
+    This version of the code is open source shared under an MIT license.
+
+    Copyright (c) 2025 Anshul Johri and Igor Mikolic-Torreira 
+
+    See DebugUtils.hpp for the full license text.
+*/
+
+
+
+module;
+
+// The standard headers used by DebugUtils.hpp, so that they are in the global module fragment rather
+// than attached to (and exported from) the DebugUtils module
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <source_location>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined( __linux__ )
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+export module DebugUtils;
+
+// The stream inserters are found by ordinary lookup from the DebugUtils templates.  Otherwise GCC 12 only
+// looks for them by argument dependent lookup when the templates are instantiated in an importing 
+// translation unit, and doesn't find the ones for character strings.
+namespace DebugUtils
+{
+    using std::operator<<;
+}
+
+export
+{
+    #include "DebugUtils.hpp"
+}
+
+// GCC 12 only emits the static locals of inline functions (e.g., the call site list of callSites()) in the object 
+// files that use them, and an importing translation unit expects them in the module's object file
+namespace DebugUtils
+{
+    [[gnu::used]] const auto callSitesEmitted = 
+        static_cast<const std::vector<const CallSite*>& (*)( TypeSelect<DEBUGUTILS_FULL_HEADER>::type )>( &callSites );
+}
@@ -11,6 +11,17 @@
     by the compiler) and function overloading.  Certain template specializations and function overloads 
     generate debugging code; other template specializations and function overloads generate no code.
 
+    Besides the defaults of the configuration macros, three preprocessor conditionals remain.  They decide how 
+    much of this header the compiler reads and what the platform supports, not what debugging code is generated:
+      - #if DEBUGUTILS_FULL_HEADER:  when DEBUGUTILS_ON is zero only the policies, call site descriptors, empty 
+        functions and macros are compiled, so the header includes no streams (and adds no static initializers) 
+        and costs very little compile time.  The debugging code itself is compiled when DEBUGUTILS_ON (or 
+        DEBUGUTILS_FULL_HEADER) is non-zero.
+      - DEBUGUTILS_SITE_SECTION is set from the platform macros (ELF executables on x86-64 or AArch64), and an
+        if constexpr on it decides whether call sites are registered in a linker section.
+      - #if DEBUGUTILS_INOTIFY (set on Linux) includes the inotify headers and FilterWatcher, which watches filter
+        files; elsewhere filter files are only read at startup.
+
     When compiled on GCC v13 with -O2 and DEBUGUTILS_ON=0, code size is exactly the same as when all 
     DebugUtils debugging calls are manual editted out from the source code.
 
@@ -18,10 +29,12 @@
     enables the debug printing of complex nested data types and data structures (e.g., vectors of pairs, 
     lists of vectors, maps of strings, queues of tuples).
 
-    A small number of preprocessor macros are provided to provide a way to conveniently capture __FILE__ and 
-    __LINE__ at the point of calling the debugging functions.  If someone knows a way to do this without using 
-    a macro function, let me know!  Note that none of these macros are conditional.  Another macro simply hides
-    a simple but rote object instantiation and is absolutely not necessary.
+    A small number of preprocessor macros are provided to provide a way to conveniently capture the call site 
+    (file, line and function, via std::source_location) and the names of the arguments at the point of calling 
+    the debugging functions.  Each call site gets one static constexpr descriptor (with a stable ID) and the 
+    debugging functions are passed a single pointer to it.  If someone knows a way to capture the argument names
+    without using a macro function, let me know!  Note that none of these macros are conditional.  Another macro 
+    simply hides a simple but rote object instantiation and is absolutely not necessary.
 
     This code was an experiment to see how far modern C++20 tools can replace the preprocessor to conditionally 
     generate code.  Turns out I was able to entirely replace it.
@@ -60,15 +73,13 @@
 #ifndef DebugUtils_hpp
 #define DebugUitls_hpp
 
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <filesystem>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
 #include <type_traits>
-#include <string>
-#include <iomanip>
-#include <ctime>
-#include <bits/stdc++.h>
+#include <utility>
+#include <vector>
 
 
 
@@ -76,6 +87,40 @@
     #define DEBUGUTILS_ON 0
 #endif
 
+// Minimum log level compiled in when DEBUGUTILS_ON is non-zero:  
+// 0 = Trace, 1 = Debug, 2 = Info, 3 = Warn, 4 = Error
+#ifndef DEBUGUTILS_LEVEL
+    #define DEBUGUTILS_LEVEL 0
+#endif
+
+// Consecutive identical records are collapsed into one, followed by the number of repeats, for up to this many 
+// milliseconds (0 = never collapse records)
+#ifndef DEBUGUTILS_COLLAPSE_MS
+    #define DEBUGUTILS_COLLAPSE_MS 1000
+#endif
+
+// The debugging code of this header is only compiled when it can be used:  when DEBUGUTILS_ON is non-zero,
+// or when DEBUGUTILS_FULL_HEADER is non-zero (needed for categories declared std::true_type while 
+// DEBUGUTILS_ON is zero).  Otherwise only the policies, the empty functions and the macros are compiled.
+#ifndef DEBUGUTILS_FULL_HEADER
+    #define DEBUGUTILS_FULL_HEADER DEBUGUTILS_ON
+#endif
+
+// Call sites are registered in the debugutils_sites linker section where the toolchain allows it 
+// (ELF executables on x86-64 or AArch64; not -fPIC shared libraries)
+#if defined( __ELF__ ) && ( defined( __x86_64__ ) || defined( __aarch64__ ) ) && !( defined( __PIC__ ) && !defined( __PIE__ ) )
+    #define DEBUGUTILS_SITE_SECTION 1
+#else
+    #define DEBUGUTILS_SITE_SECTION 0
+#endif
+
+// Filter files are watched for changes (see FilterWatcher) where inotify is available (Linux)
+#if defined( __linux__ )
+    #define DEBUGUTILS_INOTIFY 1
+#else
+    #define DEBUGUTILS_INOTIFY 0
+#endif
+
 
 
 
@@ -101,260 +146,342 @@ namespace DebugUtils
 
 
 
+    // Log levels are tag types ordered by their value
+    template <int N>
+    struct LogLevel : std::integral_constant<int, N> {};
+
+    struct Trace : LogLevel<0> {};
+    struct Debug : LogLevel<1> {};
+    struct Info  : LogLevel<2> {};
+    struct Warn  : LogLevel<3> {};
+    struct Error : LogLevel<4> {};
+
+    template <typename T>
+    concept is_level = requires { T::value; } && std::is_base_of_v<LogLevel<T::value>, T>;
+
+
+
+    // LevelPolicy<Level> is the policy for debugging at a given log level.  Levels below 
+    // DEBUGUTILS_LEVEL get std::false_type, so their debugging calls generate no code.
+
+    template <typename Level>
+    using LevelPolicy = typename TypeSelect<DEBUGUTILS_ON && Level::value >= DEBUGUTILS_LEVEL>::type;
+
+
+
     // DebugUtilsPolicy is a type used to manage template instantiation and specialization,
-    // as well as overload resolution.
+    // as well as overload resolution.  It is the policy of the Debug log level. 
     
     // When DebugUtilsPolicy == std::true_type, code for debugging is compiled.
     // When DebugUtilsPolicy == std::false_type, it is not.
 
-    using DebugUtilsPolicy = typename TypeSelect<DEBUGUTILS_ON>::type;
+    using DebugUtilsPolicy = LevelPolicy<Debug>;
 
 
 
-    // This generic type is an intentionally trivial class
-    template <typename T>
-    class DebugFileOnBase
+    // Categories are tag types that let individual components have their own policy.  The policy of a 
+    // category is the return type of debugCategoryPolicy( Category ), found by argument dependent lookup, so
+    // it is declared (never defined) next to the category.  For example: 
+    //
+    //      namespace net 
+    //      {
+    //          struct Sockets {};
+    //          std::true_type debugCategoryPolicy( Sockets );
+    //      }
+    //
+    // A declaration taking a base class covers every category derived from it (e.g., a whole namespace), 
+    // and a static declaration sets the policy for just one translation unit.  Categories that don't 
+    // declare a policy follow DebugUtilsPolicy.
+
+    DebugUtilsPolicy debugCategoryPolicy( ... );
+
+    template <typename Category>
+    using CategoryPolicy = decltype( debugCategoryPolicy( std::declval<Category>() ) );
+
+    // Wraps a category for overload resolution of the debugging functions
+    template <typename Category>
+    struct InCategory {};
+
+    // A category that is on needs the debugging code (see DEBUGUTILS_FULL_HEADER)
+    template <typename Category>
+    inline constexpr bool categoryCompiled = !CategoryPolicy<Category>::value || DEBUGUTILS_FULL_HEADER;
+
+
+
+    // Everything known at compile time about a call site of the debugging functions.  The macros create
+    // one static constexpr CallSite per call site and pass the debugging functions a pointer to it. 
+
+    // Directory-free part of a source file path
+    constexpr const char* baseName( const char* path )
     {
-        public:
-            constexpr DebugFileOnBase( T, const char* ) {}
+        const char* name = path;
+        for ( const char* p = path; *p; p++ )
+        {
+            if ( *p == '/' or *p == '\\' )
+                name = p + 1;
+        }
+        return name;
+    }
+
+    // Call site ID, a FNV-1a hash of the source file path, line and column numbers, function name and argument 
+    // names (so two call sites on one line, e.g., in a macro, get different IDs).  It is stable from build to 
+    // build as long as the call site itself doesn't change or move.
+    constexpr std::uint32_t callSiteId( const char* path, std::uint32_t lineNbr, std::uint32_t column, const char* function, const char* names )
+    {
+        std::uint32_t h{ 2166136261u };
+        auto mix = [&h]( std::uint32_t c ) { h = ( h ^ c ) * 16777619u; };
+        auto mixString = [&mix]( const char* str ) 
+        { 
+            for ( const char* p = str; *p; p++ )
+                mix( static_cast<unsigned char>( *p ) );
+        };
+        auto mixNumber = [&mix]( std::uint32_t n )
+        {
+            for ( int i = 0; i < 4; i++ )
+                mix( ( n >> ( 8 * i ) ) & 0xff );
+        };
+        mixString( path );
+        mixNumber( lineNbr );
+        mixNumber( column );
+        mixString( function );
+        mixString( names );
+        return h;
+    }
+
+    // Runtime switch of a call site (see enableSites()).  The macros give each call site its own next to its 
+    // descriptor.  It is only ever accessed through std::atomic_ref, so this part of the header needs no <atomic>.
+    struct SiteFlag
+    {
+        bool            on{ true };
     };
 
-    // Specialization applies when debug mode is on (DebugUtilsPolicy == std::true_type)
-    // It is the only template instantiation that does anything
-    template <>
-    class DebugFileOnBase<std::true_type>
+    struct CallSite
     {
-        public:
-            DebugFileOnBase( std::true_type, const char* filename ) 
-                : mDebugLogFile{}, mOriginalCerrBuff{ nullptr }
-            {
-                auto t = std::time( nullptr );
-                auto tm = *std::localtime( &t );
-                std::ostringstream oss;
-                oss << std::put_time( &tm, "%Y%m%d_%H%M%S" );
-                
-                std::string fn{ filename };
-                fn += '_' + oss.str() + ".log";
-                mDebugLogFile.open( fn );
-                if ( mDebugLogFile )
-                {
-                    mOriginalCerrBuff = std::cerr.rdbuf();          // Save cerr buffer to restore in destructor
-                    std::cerr.rdbuf( mDebugLogFile.rdbuf() );
-                    std::cerr << "Debug logging redirected to file " << fn << std::endl;
-                }
-                else
-                {
-                    // In case of error, std:cerr remains as it was
-                    std::cerr << "Unable to open debug logging file " << fn << std::endl;
-                }
-            }
+        const char*     path;           // Source file as named by the compiler
+        const char*     filename;       // Source file without its directories
+        const char*     function;
+        int             lineNbr;
+        const char*     names;          // Catenation of the argument names
+        int             level;
+        const char*     category;
+        std::uint32_t   id;
+        SiteFlag*       flag;
+
+        constexpr CallSite( std::source_location loc, SiteFlag* siteFlag, const char* argNames, int logLevel = Debug::value, const char* categoryName = "" )
+            : path{ loc.file_name() }, filename{ baseName( loc.file_name() ) }, function{ loc.function_name() }, 
+              lineNbr{ static_cast<int>( loc.line() ) }, names{ argNames }, level{ logLevel }, category{ categoryName }, 
+              id{ callSiteId( loc.file_name(), loc.line(), loc.column(), loc.function_name(), argNames ) }, flag{ siteFlag }
+        {}
+    };
 
-            ~DebugFileOnBase()
-            {
-                std::cerr << "Closing the debug logging file" << std::endl;
-                if ( mOriginalCerrBuff )
-                {
-                    std::cerr.rdbuf( mOriginalCerrBuff );       // Restore cerr
-                }
-                // ofstream destructor closes the file
-            }
 
 
-        private:
-            std::ofstream       mDebugLogFile;
-            std::streambuf*     mOriginalCerrBuff;
+    // Registry of call sites.  When a call site's policy is std::true_type, a pointer to its descriptor is
+    // placed in the debugutils_sites section of the binary.  The linker gathers these pointers from all the 
+    // object files into one array (between __start_debugutils_sites and __stop_debugutils_sites), so every 
+    // call site compiled into the binary can be listed without any registration code running at startup.
+    // Call sites whose policy is std::false_type generate no code and aren't registered.  callSites() lists them.
+
+    // Debugging version overload (defined below with the rest of the debugging code)
+    inline const std::vector<const CallSite*>& callSites( std::true_type );
+
+    // Non-debugging version overload, no call site is registered
+    inline const std::vector<const CallSite*>& callSites( std::false_type )
+    {
+        static const std::vector<const CallSite*> none;
+        return none;
+    }
+
+    // Function actually called in user code, it lists the registered call sites in no particular order
+    inline const std::vector<const CallSite*>& callSites()
+    {
+        return callSites( TypeSelect<DEBUGUTILS_FULL_HEADER>::type{} );
+    }
+
+}   // namespace DebugUtils
+
+extern "C" [[gnu::weak, gnu::visibility( "hidden" )]] const DebugUtils::CallSite* const __start_debugutils_sites[];
+extern "C" [[gnu::weak, gnu::visibility( "hidden" )]] const DebugUtils::CallSite* const __stop_debugutils_sites[];
+
+namespace DebugUtils
+{
+
+    // Debugging version overload, records the call site in the debugutils_sites section
+    template <const CallSite* Site>
+    inline void registerCallSite( std::true_type )
+    {
+        if constexpr ( DEBUGUTILS_SITE_SECTION )
+        {
+            asm( ".pushsection debugutils_sites,\"aw\"\n\t.balign 8\n\t.quad %c0\n\t.popsection" :: "i"( Site ) );
+        }
+    }
+
+    // Non-debugging version overload, an empty function
+    template <const CallSite* Site>
+    constexpr void registerCallSite( std::false_type ) {}
+
+
+
+    //*** Deferred arguments
+
+    // The arguments of the debugging functions are deferred:  the macros wrap them in a lambda that passes them 
+    // to the function it is given, [&]( auto&& debugUtilsEmit ) { debugUtilsEmit( args... ); }.  They are only 
+    // evaluated when a record is emitted, once the call site's policy, runtime switch, condition and gate all 
+    // let it through.
+    template <typename F>
+    struct Deferred
+    {
+        F       pass;
     };
 
 
-    class DebugFileOn : public DebugFileOnBase<DebugUtilsPolicy>
+
+    // This generic type is an intentionally trivial class.  The specialization for std::true_type is defined 
+    // with the rest of the debugging code, and DebugFileOn after it.
+    template <typename T>
+    class DebugFileOnBase
     {
         public:
-            DebugFileOn( const char* filename ) : DebugFileOnBase( DebugUtilsPolicy{}, filename ) {}
+            constexpr DebugFileOnBase( T, const char* ) {}
+
+            template <typename Filename>
+            constexpr DebugFileOnBase( T, Deferred<Filename> ) {}
     };
 
 
 
-    // Following code uses template recursion on variadic function templates. 
-    // The various functions print(...) provide the base case for template recursion.
+    // Following sets up the functions actually called by user code.  They are overloaded on the first parameter.
+    // When the first parameter is of type convertible to std::true_type, actual debug code is generated.
+    // When the first parameter is convertible to std::false_type, empty functions (compiler eliminated) are generated.
+    // The debugging versions are only declared here, they are defined with the rest of the debugging code.
 
-    // The functions below handle single arguments, which provide the "base cases" for 
-    // template recursion. Base case in the context means the single argument case
-    
-    // These handle specific types of single arguments base cases
-    inline void print( const char* x )  { std::cerr << x; }
 
-    inline void print( char x )  { std::cerr << "\'" << x << "\'"; }
+    //*** enableSites() variants
 
-    inline void print( bool x )  { std::cerr << (x ? "T" : "F"); }
+    // Selects call sites by any combination of source file, line range, function and category, for their
+    // runtime switches.  Members left null select everything, e.g., enableSites( { .file = "net/*.cpp" } ).
+    struct SiteSelector
+    {
+        const char*     file{ nullptr };        // Glob ('*' and '?', which don't match '/') matched against 
+                                                // the whole path or its end after a '/'
+        int             firstLine{ 0 };
+        int             lastLine{ INT_MAX };
+        const char*     function{ nullptr };    // Any part of the function's signature
+        const char*     category{ nullptr };    // Category as written at the call site
+        int             minLevel{ Trace::value };
+    };
 
-    inline void print( std::string x )  { std::cerr << "\"" << x << "\""; }
+    // Debugging version overload (defined below with the rest of the debugging code)
+    inline std::size_t enableSites( std::true_type, const SiteSelector& selector, bool on );
 
-    inline void print( std::vector<bool>& v )
-    { 
-        // This overload because stl optimizes vector<bool> by using
-        // _Bit_reference instead of bool to conserve space.
-        int f{ 0 };
-        std::cerr << '{';
-        for ( auto &&i : v )
-        {
-            std::cerr << (f++ ? "," : "") << ( i ? "T" : "F" );
-        }
-        std::cerr << "}";
-    }
+    // Non-debugging version overload, there are no call sites to switch
+    constexpr std::size_t enableSites( std::false_type, const SiteSelector&, bool ) { return 0; }
 
-    // Helper concept/requirement processing the generic base case
-    template <typename T>
-    concept is_iterable = requires( T &&x ) { begin(x); } &&
-                            !std::is_same_v<std::remove_cvref_t<T>, std::string>;
+    // Functions actually called in user code, they switch the selected call sites on (or off) and return how 
+    // many call sites were selected.  There are call sites to switch whenever the debugging code is compiled.
+    inline std::size_t enableSites( const SiteSelector& selector, bool on = true )
+    {
+        return enableSites( TypeSelect<DEBUGUTILS_FULL_HEADER>::type{}, selector, on );
+    }
 
-    // This template handles all other single argument cases
-    template <typename T>
-    void print( T&& x )
+    inline std::size_t disableSites( const SiteSelector& selector )
     {
-        if constexpr ( is_iterable<T> )                                 // Various iterables...
-        {
-            if ( size(x) && is_iterable<decltype( *(begin(x)) )> )      // Iterable inside Iterable
-            {
-                int f{ 0 };
-                std::cerr << "\n~~~~~\n";
-                int w = std::max( 0, (int) std::log10( size(x) - 1 ) ) + 2;
-                for ( auto&& i : x )
-                {
-                    std::cerr << std::setw(w) << std::left << f++, print(i), std::cerr << "\n";
-                }
-                std::cerr << "~~~~~\n";
-            }
-            else                                                        // A plain, normal Iterable
-            {
-                int f{ 0 };
-                std::cerr << "{";
-                for ( auto&& i : x )
-                {
-                    std::cerr << ( f++ ? "," : "" ), print( i );
-                }
-                std::cerr << "}";
-            }
-        }
-        else if constexpr ( requires { x.pop(); } )                     // Stacks, Priority Queues, Queues 
-        {
-            auto temp{ x };
-            int f{ 0 };
-            std::cerr << "{";
-            if constexpr ( requires { x.top(); } )
-            {            
-                while ( !temp.empty() )
-                    std::cerr << ( f++ ? "," : "" ), print( temp.top() ), temp.pop();
-            }
-            else
-            {
-                while ( !temp.empty() )
-                    std::cerr << ( f++ ? "," : "" ), print( temp.front() ), temp.pop();
-            }
-            std::cerr << "}";
-        }
-        else if constexpr ( requires { x.first; x.second; } )           // Pair 
-        {
-            std::cerr << '(', print( x.first ), std::cerr << ',', print( x.second ), std::cerr << ')';
-        }
-        else if constexpr ( requires { get<0>(x); } )                   // Tuple 
-        {
-            int f{ 0 };
-            std::cerr << '(', apply( [&f](auto... args) { (( std::cerr << (f++ ? "," : ""), print(args) ), ...); }, x );
-            std::cerr << ')';
-        }
-        else
-        {
-            std::cerr << x;                                             // Anything else
-        }
+        return enableSites( selector, false );
     }
 
 
-    // This is the variadic function that drives the template recursion
-    // Single arguments are passed to one of the print() functions
-    // The "tail" argument(s) is/are passed back to the printer() 
-    // function (but with one less argument to trigger the template recursion)
-    template <typename T, typename... V>
-    void printerV( const char* names, T&& head, V&&... tail )
+    //*** applyFilter() variants
+
+    // Debugging version overloads (defined below with the rest of the debugging code)
+    inline bool applyFilter( std::true_type, const char* spec );
+    inline bool applyFilterFile( std::true_type, const char* filename );
+
+    // Non-debugging version overloads, there are no call sites to filter
+    constexpr bool applyFilter( std::false_type, const char* ) { return true; }
+    constexpr bool applyFilterFile( std::false_type, const char* ) { return true; }
+
+    // Functions actually called in user code, they switch every call site on or off as selected by a filter spec 
+    // (see Filter), given as a string or in a file.  They return false if some of the spec couldn't be used.
+    inline bool applyFilter( const char* spec )
     {
-        int i{ 0 };
-        for ( int bracket = 0; names[i] != '\0' and ( names[i] != ',' or bracket > 0 ); i++ )
-        {
-            if ( names[i] == '(' or names[i] == '<' or names[i] == '{' )
-                bracket++;
-            else if ( names[i] == ')' or names[i] == '>' or names[i] == '}' )
-                bracket--;
-        }
-        std::cerr.write( names, i ) << " = ";
-        print( std::forward<T>( head ) );
-        if constexpr ( sizeof...(tail) )
-        {
-            std::cerr << " ||", printerV( names + i + 1, std::forward<V>( tail )... );
-        }
-        else
-        {    
-            std::cerr << " ]\n";
-        }
+        return applyFilter( TypeSelect<DEBUGUTILS_FULL_HEADER>::type{}, spec );
     }
 
-
-    // This a version of the variadic function for plain arrays 
-    // Pass using macros as debugArr( array1Ptr, N1, array2Ptr, N2, array3Ptr, N3 )
-    // It works the same way as printer()
-    template <typename T, typename... V>
-    void printerArr( const char* names, T arr[], size_t n, V... tail )
+    inline bool applyFilterFile( const char* filename )
     {
-        size_t i = 0;
-        for ( ; names[i] and names[i] != ','; i++ )
-            std::cerr << names[i];
-        for ( i++; names[i] and names[i] != ','; i++ )
-            ;
-        std::cerr << " = {";
-        for ( size_t ind = 0; ind < n; ind++ )
-            std::cerr << ( ind ? "," : "" ), print( arr[ind] );
-        std::cerr << "}";
-        if constexpr ( sizeof...( tail ) )
-            std::cerr << " ||", printerArr( names + i + 1, tail... );
-        else
-            std::cerr << " ]\n";
+        return applyFilterFile( TypeSelect<DEBUGUTILS_FULL_HEADER>::type{}, filename );
     }
 
 
+    //*** enableBacktrace() and flushBacktrace() variants
 
-    // Following sets up the functions actually called by user code.  They are overloaded on the first parameter.
-    // When the first parameter is of type convertible to std::true_type, actual debug code is generated.
-    // When the first parameter is convertible to std::false_type, empty functions (compiler eliminated) are generated.
+    // Backtrace mode:  the records below Error level aren't output, each thread keeps its last nbrRecords records
+    // in memory instead (see BacktraceRing).  A thread's records are output when it emits an Error level record,
+    // when it calls flushBacktrace(), and when it crashes.
 
+    // Debugging version overloads (defined below with the rest of the debugging code)
+    inline void enableBacktrace( std::true_type, std::size_t nbrRecords );
+    inline void flushBacktrace( std::true_type );
 
-    //*** debugPrinterV() variants
+    // Non-debugging version overloads, there are no records
+    constexpr void enableBacktrace( std::false_type, std::size_t ) {}
+    constexpr void flushBacktrace( std::false_type ) {}
 
-    // Debugging version overload
-    template <typename T, typename... V>
-    void debugPrinterV( std::true_type, const char* filename, int lineNbr, const char* names, T&& head, V&&... tail )
+    // Functions actually called in user code, nbrRecords = 0 turns backtrace mode off (the records kept are lost)
+    inline void enableBacktrace( std::size_t nbrRecords )
+    {
+        enableBacktrace( TypeSelect<DEBUGUTILS_FULL_HEADER>::type{}, nbrRecords );
+    }
+
+    // Outputs the records kept by the calling thread
+    inline void flushBacktrace()
     {
-        std::cerr << std::filesystem::path{ filename }.filename().string() << "(" << lineNbr << ") [ ", 
-            printerV( names, std::forward<T>( head ), std::forward<V>( tail )... );
+        flushBacktrace( TypeSelect<DEBUGUTILS_FULL_HEADER>::type{} );
     }
 
+
+    //*** debugPrinterV() variants
+
+    // Debugging version overload (defined below with the rest of the debugging code)
+    template <typename Args>
+    void debugPrinterV( std::true_type, const CallSite* site, Deferred<Args> args );
+
     // Non-debugging version overload, an empty function
-    template <typename T, typename... V>
-    constexpr void debugPrinterV( std::false_type, const char* filename, int lineNbr, const char* names, T&& head, V&&... tail ) {}
+    template <typename Args>
+    constexpr void debugPrinterV( std::false_type, const CallSite* site, Deferred<Args> args ) {}
  
     // Function overload actually called in user code that triggers selection of debug/non-debug versions
-    template <typename T, typename... V>
-    void debugPrinterV( const char* filename, int lineNbr, const char* names, T&& head, V&&... tail )
+    template <typename Args>
+    void debugPrinterV( const CallSite* site, Deferred<Args> args )
     {
-        debugPrinterV( DebugUtilsPolicy{}, filename, lineNbr, names, std::forward<T>( head ), std::forward<V>( tail )... );
+        debugPrinterV( DebugUtilsPolicy{}, site, args );
+    }
+ 
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions, log level version
+    template <typename Level, typename Args>
+        requires is_level<Level>
+    void debugPrinterV( Level, const CallSite* site, Deferred<Args> args )
+    {
+        debugPrinterV( LevelPolicy<Level>{}, site, args );
+    }
+ 
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions, category version
+    template <typename Category, typename Args>
+    void debugPrinterV( InCategory<Category>, const CallSite* site, Deferred<Args> args )
+    {
+        static_assert( categoryCompiled<Category>, "Category is on but the debugging code isn't compiled, define DEBUGUTILS_FULL_HEADER=1" );
+        debugPrinterV( CategoryPolicy<Category>{}, site, args );
     }
  
     // Function overload actually called in user code that triggers selection of debug/non-debug versions, conditional version
-    template <typename T, typename... V>
-    void debugPrinterV( bool active, const char* filename, int lineNbr, const char* names, T&& head, V&&... tail )
+    template <typename Args>
+    void debugPrinterV( bool active, const CallSite* site, Deferred<Args> args )
     {
         if constexpr ( std::is_convertible<DebugUtilsPolicy, std::true_type>::value )
         {
-            if ( active )
+            if ( active ) [[unlikely]]
             {
-                debugPrinterV( DebugUtilsPolicy{}, filename, lineNbr, names, std::forward<T>( head ), std::forward<V>( tail )... );
+                debugPrinterV( DebugUtilsPolicy{}, site, args );
             }
         }
     }
@@ -362,88 +489,2440 @@ namespace DebugUtils
 
     //*** debugPrinterArr() variants
 
-    // Debugging version overload
-    template <typename T, typename... V>
-    void debugPrinterArr( std::true_type, const char* filename, int lineNbr, const char* names, T arr[], size_t n, V... tail )
-    {
-        std::cerr << std::filesystem::path{ filename }.filename().string() << "(" << lineNbr << ") [ ", printerArr( names, arr, n, tail... );
-    }
+    // Debugging version overload (defined below with the rest of the debugging code)
+    template <typename Args>
+    void debugPrinterArr( std::true_type, const CallSite* site, Deferred<Args> args );
 
     // Non-debugging version overload
-    template <typename T, typename... V>
-    constexpr void debugPrinterArr( std::false_type, const char* filename, int lineNbr, const char* names, T arr[], size_t n, V... tail ) {}
+    template <typename Args>
+    constexpr void debugPrinterArr( std::false_type, const CallSite* site, Deferred<Args> args ) {}
 
     // Function overload actually called in user code that triggers selection of debug/non-debug versions
-    template <typename T, typename... V>
-    void debugPrinterArr( const char* filename, int lineNbr, const char* names, T arr[], size_t n, V... tail )
+    template <typename Args>
+    void debugPrinterArr( const CallSite* site, Deferred<Args> args )
+    { 
+        debugPrinterArr( DebugUtilsPolicy{}, site, args );
+    }
+
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions, log level version
+    template <typename Level, typename Args>
+        requires is_level<Level>
+    void debugPrinterArr( Level, const CallSite* site, Deferred<Args> args )
     { 
-        debugPrinterArr( DebugUtilsPolicy{}, filename, lineNbr, names, arr, n, tail... );
+        debugPrinterArr( LevelPolicy<Level>{}, site, args );
+    }
+
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions, category version
+    template <typename Category, typename Args>
+    void debugPrinterArr( InCategory<Category>, const CallSite* site, Deferred<Args> args )
+    { 
+        static_assert( categoryCompiled<Category>, "Category is on but the debugging code isn't compiled, define DEBUGUTILS_FULL_HEADER=1" );
+        debugPrinterArr( CategoryPolicy<Category>{}, site, args );
     }
 
     // Function overload actually called in user code that triggers selection of debug/non-debug versions, conditional version
-    template <typename T, typename... V>
-    void debugPrinterArr( bool active, const char* filename, int lineNbr, const char* names, T arr[], size_t n, V... tail )
+    template <typename Args>
+    void debugPrinterArr( bool active, const CallSite* site, Deferred<Args> args )
     { 
         if constexpr ( std::is_convertible<DebugUtilsPolicy, std::true_type>::value )
         {
-            if ( active )
+            if ( active ) [[unlikely]]
             {
-                debugPrinterArr( DebugUtilsPolicy{}, filename, lineNbr, names, arr, n, tail... );
+                debugPrinterArr( DebugUtilsPolicy{}, site, args );
             }
         }
     }
 
 
-    //*** debugMsg() variants ***
+    //*** debugDiffPrinterV() variants
 
-    // This is a function to simply print a simple message to debug (no variables dumped)
+    // Debugging version overload (defined below with the rest of the debugging code)
+    template <const CallSite* Site, typename Args>
+    void debugDiffPrinterV( std::true_type, Deferred<Args> args );
 
-    // Debugging version overload
-    template<typename T>
-    void debugMsg( std::true_type, const char* filename, int lineNbr, T&& output )
+    // Non-debugging version overload, an empty function
+    template <const CallSite* Site, typename Args>
+    constexpr void debugDiffPrinterV( std::false_type, Deferred<Args> args ) {}
+
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions
+    template <const CallSite* Site, typename Args>
+    void debugDiffPrinterV( Deferred<Args> args )
     {
-        std::cerr << std::filesystem::path{ filename }.filename().string() << "(" << lineNbr << "): " << output << std::endl;
+        debugDiffPrinterV<Site>( DebugUtilsPolicy{}, args );
     }
 
-    // Non-debuging version overload
-    template<typename T>
-    constexpr void debugMsg( std::false_type, const char*,  int, T&& ) {}
+
+    //*** debugDedupPrinterV() variants
+
+    // Debugging version overload (defined below with the rest of the debugging code)
+    template <const CallSite* Site, typename Args>
+    void debugDedupPrinterV( std::true_type, Deferred<Args> args );
+
+    // Non-debugging version overload, an empty function
+    template <const CallSite* Site, typename Args>
+    constexpr void debugDedupPrinterV( std::false_type, Deferred<Args> args ) {}
 
     // Function overload actually called in user code that triggers selection of debug/non-debug versions
-    template <typename T>
-    void debugMsg( const char* filename, int lineNbr, T&& output )
+    template <const CallSite* Site, typename Args>
+    void debugDedupPrinterV( Deferred<Args> args )
     {
-        debugMsg( DebugUtilsPolicy{}, filename, lineNbr, std::forward<T>( output ) );
+        debugDedupPrinterV<Site>( DebugUtilsPolicy{}, args );
     }
 
-    // Function overload actually called in user code that triggers selection of debug/non-debug versions, conditional version
-    template <typename T>
-    void debugMsg( bool active, const char* filename, int lineNbr, T&& output )
-    {
-        if constexpr ( std::is_convertible<DebugUtilsPolicy, std::true_type>::value )
-        {
-            if ( active )
-            {
-                debugMsg( DebugUtilsPolicy{}, filename, lineNbr, std::forward<T>( output ) );
+
+    //*** debugOnChangePrinterV() and debugWatchPrinterV() variants
+
+    // Watchpoints keep a shadow of the watched variable per call site (see WatchState) and only emit a record
+    // when the variable changes (debugOnChangePrinterV) or when a predicate of it flips (debugWatchPrinterV).
+    // The deferred arguments are the variable, and for debugWatchPrinterV the predicate.
+
+    // Debugging version overloads (defined below with the rest of the debugging code)
+    template <const CallSite* Site, typename Args>
+    void debugOnChangePrinterV( std::true_type, Deferred<Args> args );
+
+    template <const CallSite* Site, typename Args>
+    void debugWatchPrinterV( std::true_type, Deferred<Args> args );
+
+    // Non-debugging version overloads, empty functions
+    template <const CallSite* Site, typename Args>
+    constexpr void debugOnChangePrinterV( std::false_type, Deferred<Args> ) {}
+
+    template <const CallSite* Site, typename Args>
+    constexpr void debugWatchPrinterV( std::false_type, Deferred<Args> ) {}
+
+    // Function overloads actually called in user code that trigger selection of debug/non-debug versions
+    template <const CallSite* Site, typename Args>
+    void debugOnChangePrinterV( Deferred<Args> args )
+    {
+        debugOnChangePrinterV<Site>( DebugUtilsPolicy{}, args );
+    }
+
+    template <const CallSite* Site, typename Args>
+    void debugWatchPrinterV( Deferred<Args> args )
+    {
+        debugWatchPrinterV<Site>( DebugUtilsPolicy{}, args );
+    }
+
+
+    //*** debugGatedPrinterV(), debugGatedPrinterArr() and debugGatedMsg() variants
+
+    // A gate lets only some of the hits of a call site through, e.g., RateLimit or FirstN.  The gate's state is kept per 
+    // call site (see DiffState), and gatePasses<Site>( gate ) decides on each hit, after the call site's runtime 
+    // switch.  Both are defined with the rest of the debugging code.
+
+    // At most perSecond records per second, in bursts of up to burst records.  The number of suppressed records 
+    // is reported with the next record that gets through.
+    struct RateLimit
+    {
+        double      perSecond;
+        double      burst;
+    };
+
+    // The first n hits of the call site
+    struct FirstN
+    {
+        std::uint64_t   n;
+    };
+
+    // Every nth hit of the call site, starting with the first
+    struct EveryN
+    {
+        std::uint64_t   n;
+    };
+
+    // The first hit of the call site and then at most one hit per interval (a std::chrono::duration)
+    template <typename Duration>
+    struct EveryT
+    {
+        Duration        interval;
+    };
+
+    // Debugging version overloads (defined below with the rest of the debugging code)
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedPrinterV( std::true_type, const Gate& gate, Deferred<Args> args );
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedPrinterArr( std::true_type, const Gate& gate, Deferred<Args> args );
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedMsg( std::true_type, const Gate& gate, Deferred<Args> args );
+
+    // Non-debugging version overloads, empty functions
+    template <const CallSite* Site, typename Gate, typename Args>
+    constexpr void debugGatedPrinterV( std::false_type, const Gate&, Deferred<Args> ) {}
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    constexpr void debugGatedPrinterArr( std::false_type, const Gate&, Deferred<Args> ) {}
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    constexpr void debugGatedMsg( std::false_type, const Gate&, Deferred<Args> ) {}
+
+    // Function overloads actually called in user code that trigger selection of debug/non-debug versions
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedPrinterV( const Gate& gate, Deferred<Args> args )
+    {
+        debugGatedPrinterV<Site>( DebugUtilsPolicy{}, gate, args );
+    }
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedPrinterArr( const Gate& gate, Deferred<Args> args )
+    {
+        debugGatedPrinterArr<Site>( DebugUtilsPolicy{}, gate, args );
+    }
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedMsg( const Gate& gate, Deferred<Args> args )
+    {
+        debugGatedMsg<Site>( DebugUtilsPolicy{}, gate, args );
+    }
+
+
+    //*** debugMsg() variants ***
+
+    // This is a function to simply print a simple message to debug (no variables dumped)
+
+    // Debugging version overload (defined below with the rest of the debugging code)
+    template <typename Args>
+    void debugMsg( std::true_type, const CallSite* site, Deferred<Args> args );
+
+    // Non-debuging version overload
+    template <typename Args>
+    constexpr void debugMsg( std::false_type, const CallSite*, Deferred<Args> ) {}
+
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions
+    template <typename Args>
+    void debugMsg( const CallSite* site, Deferred<Args> args )
+    {
+        debugMsg( DebugUtilsPolicy{}, site, args );
+    }
+
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions, log level version
+    template <typename Level, typename Args>
+        requires is_level<Level>
+    void debugMsg( Level, const CallSite* site, Deferred<Args> args )
+    {
+        debugMsg( LevelPolicy<Level>{}, site, args );
+    }
+
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions, category version
+    template <typename Category, typename Args>
+    void debugMsg( InCategory<Category>, const CallSite* site, Deferred<Args> args )
+    {
+        static_assert( categoryCompiled<Category>, "Category is on but the debugging code isn't compiled, define DEBUGUTILS_FULL_HEADER=1" );
+        debugMsg( CategoryPolicy<Category>{}, site, args );
+    }
+
+    // Function overload actually called in user code that triggers selection of debug/non-debug versions, conditional version
+    template <typename Args>
+    void debugMsg( bool active, const CallSite* site, Deferred<Args> args )
+    {
+        if constexpr ( std::is_convertible<DebugUtilsPolicy, std::true_type>::value )
+        {
+            if ( active ) [[unlikely]]
+            {
+                debugMsg( DebugUtilsPolicy{}, site, args );
+            }
+        }
+    }
+
+}   // namespace DebugUtils
+
+
+
+#if DEBUGUTILS_FULL_HEADER
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#if DEBUGUTILS_INOTIFY
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+
+
+namespace DebugUtils
+{
+
+    // All the registered call sites, in no particular order.  The section can hold more than one pointer 
+    // to the same descriptor (e.g., when a call site is inlined in several places), so duplicates are removed.
+    inline const std::vector<const CallSite*>& callSites( std::true_type )
+    {
+        static const std::vector<const CallSite*> sites = []
+        {
+            std::vector<const CallSite*> v;
+            if ( __start_debugutils_sites and __stop_debugutils_sites )
+            {
+                v.assign( __start_debugutils_sites, __stop_debugutils_sites );
+            }
+            std::sort( v.begin(), v.end() );
+            v.erase( std::unique( v.begin(), v.end() ), v.end() );
+            return v;
+        }();
+        return sites;
+    }
+
+
+
+    // Runtime switches:  every call site has a flag (see SiteFlag), on by default.  The debugging functions 
+    // test it with one relaxed load before doing anything else, so a call site that is switched off costs a 
+    // load and a branch.  Call sites are switched on and off by enableSites(), which looks them up in the
+    // registry (so only registered call sites can be switched, see DEBUGUTILS_SITE_SECTION).
+
+    inline bool siteEnabled( const CallSite* site )
+    {
+        return std::atomic_ref<bool>{ site->flag->on }.load( std::memory_order_relaxed );
+    }
+
+    inline void setSiteEnabled( const CallSite* site, bool on )
+    {
+        std::atomic_ref<bool>{ site->flag->on }.store( on, std::memory_order_relaxed );
+    }
+
+
+    // Glob matching of a whole string, '*' and '?' don't match '/'
+    inline bool globMatch( std::string_view pattern, std::string_view s )
+    {
+        std::size_t p{ 0 };
+        std::size_t i{ 0 };
+        std::size_t star{ std::string_view::npos };
+        std::size_t starMatch{ 0 };
+        while ( i < s.size() )
+        {
+            if ( p < pattern.size() && pattern[p] == '*' )
+            {
+                star = p++;
+                starMatch = i;
+            }
+            else if ( p < pattern.size() && ( pattern[p] == s[i] || ( pattern[p] == '?' && s[i] != '/' ) ) )
+            {
+                p++;
+                i++;
+            }
+            else if ( star != std::string_view::npos && s[starMatch] != '/' )
+            {
+                p = star + 1;
+                i = ++starMatch;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        while ( p < pattern.size() && pattern[p] == '*' )
+        {
+            p++;
+        }
+        return p == pattern.size();
+    }
+
+    inline bool matchesFile( std::string_view pattern, std::string_view path )
+    {
+        if ( globMatch( pattern, path ) )
+        {
+            return true;
+        }
+        for ( auto slash = path.find( '/' ); slash != std::string_view::npos; slash = path.find( '/', slash + 1 ) )
+        {
+            if ( globMatch( pattern, path.substr( slash + 1 ) ) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool matches( const SiteSelector& selector, const CallSite* site )
+    {
+        return ( !selector.file || matchesFile( selector.file, site->path ) )
+            && site->lineNbr >= selector.firstLine && site->lineNbr <= selector.lastLine
+            && ( !selector.function || std::strstr( site->function, selector.function ) )
+            && ( !selector.category || std::strcmp( selector.category, site->category ) == 0 )
+            && site->level >= selector.minLevel;
+    }
+
+
+    // Debugging version overload (declared above)
+    inline std::size_t enableSites( std::true_type, const SiteSelector& selector, bool on )
+    {
+        std::size_t n{ 0 };
+        for ( auto site : callSites() )
+        {
+            if ( matches( selector, site ) )
+            {
+                setSiteEnabled( site, on );
+                n++;
+            }
+        }
+        return n;
+    }
+
+
+
+    // Repeated records (see RepeatCollapser, defined further below).  The sinks output the count of repeats that 
+    // hasn't been output yet before they change.
+    inline constexpr std::int64_t collapseWindowNs{ DEBUGUTILS_COLLAPSE_MS * 1000000LL };
+
+    inline bool isRepeat( const CallSite* site, std::uint64_t hash );
+    inline void flushRepeats();
+
+    // Held while a record is output and while a filter changes the sink (see FilterSink), so that std::cerr's 
+    // buffer is never swapped under a thread writing to it.  Recursive, for the records emitted while formatting one.
+    inline std::recursive_mutex sinkMutex;
+
+
+
+    // Backtrace mode (see enableBacktrace()), the number of records each thread keeps (0 = off)
+    inline std::atomic<std::size_t> backtraceSize{ 0 };
+
+    // Stream buffer that appends to a string, so records are formatted straight into the strings of a ring
+    class StringAppendBuf : public std::streambuf
+    {
+        public:
+            std::string*    target{ nullptr };
+
+        protected:
+            int_type overflow( int_type c ) override
+            {
+                if ( !traits_type::eq_int_type( c, traits_type::eof() ) )
+                {
+                    target->push_back( traits_type::to_char_type( c ) );
+                }
+                return traits_type::not_eof( c );
+            }
+
+            std::streamsize xsputn( const char* s, std::streamsize n ) override
+            {
+                target->append( s, static_cast<std::size_t>( n ) );
+                return n;
+            }
+    };
+
+    // A thread's last records in backtrace mode.  The strings of the records are cleared and reused, so once the
+    // ring has gone round a record costs its formatting but allocates nothing.  The records still in the ring
+    // when the thread ends are lost.
+    class BacktraceRing
+    {
+        public:
+            static BacktraceRing& local()
+            {
+                thread_local BacktraceRing ring;
+                return ring;
+            }
+
+            // The ring of the calling thread if it has one (for the crash handler, which mustn't create one)
+            static BacktraceRing* current()
+            {
+                return tCurrent;
+            }
+
+            // Adds the record formatted by format( os, context ), in place of the oldest one if the ring of size 
+            // records is full.  The records are dropped when the size of the rings changes.
+            void add( std::size_t size, void (*format)( std::ostream&, const void* ), const void* context )
+            {
+                if ( !size )
+                {
+                    return;
+                }
+                if ( mRecords.size() != size )
+                {
+                    mRecords.assign( size, std::string{} );
+                    mNext = mCount = 0;
+                }
+                auto& record = mRecords[mNext];
+                record.clear();
+                mBuf.target = &record;
+                mStream.flags( std::cerr.flags() );                 // Not copyfmt(), which copies the locale
+                mStream.precision( std::cerr.precision() );
+                mStream.fill( std::cerr.fill() );
+                format( mStream, context );
+                mNext = ( mNext + 1 ) % size;
+                mCount = std::min( mCount + 1, size );
+            }
+
+            // Outputs the records, oldest first, framed by the trigger (the call site of the Error level record,
+            // or a description), and empties the ring
+            void flush( const CallSite* site, const char* trigger )
+            {
+                if ( !mCount )
+                {
+                    return;
+                }
+                flushRepeats();
+                std::cerr << "~~~~~ backtrace, the last " << mCount << " records before ";
+                if ( site )
+                    std::cerr << site->filename << "(" << site->lineNbr << ")\n";
+                else
+                    std::cerr << trigger << "\n";
+                for ( std::size_t k = mRecords.size() - mCount; k < mRecords.size(); k++ )
+                {
+                    std::cerr << mRecords[( mNext + k ) % mRecords.size()];
+                }
+                std::cerr << "~~~~~" << std::endl;
+                mCount = 0;
+            }
+
+            ~BacktraceRing()
+            {
+                tCurrent = nullptr;
+            }
+
+        private:
+            BacktraceRing()
+            {
+                tCurrent = this;
+            }
+
+            static inline thread_local BacktraceRing*   tCurrent{ nullptr };
+
+            std::vector<std::string>    mRecords;
+            std::size_t                 mNext{ 0 };
+            std::size_t                 mCount{ 0 };
+            StringAppendBuf             mBuf;
+            std::ostream                mStream{ &mBuf };
+    };
+
+    // Sends a record, formatted by format( os, context ), to the sink.  In backtrace mode the records below Error
+    // level go to the thread's ring, and an Error level record outputs the ring first.  Otherwise the record is
+    // output unless it repeats the previous record (hash( context ) is only called when records are collapsed).
+    inline void sendRecord( std::ostream& os, const CallSite* site, std::uint64_t (*hash)( const void* ), 
+                            void (*format)( std::ostream&, const void* ), const void* context )
+    {
+        // Loaded once:  enableBacktrace() may change it meanwhile
+        std::size_t size = backtraceSize.load( std::memory_order_relaxed );
+        if ( size && site->level < Error::value ) [[unlikely]]
+        {
+            BacktraceRing::local().add( size, format, context );
+            return;
+        }
+
+        std::lock_guard lock{ sinkMutex };
+        if ( size ) [[unlikely]]
+        {
+            BacktraceRing::local().flush( site, nullptr );
+        }
+        if ( !isRepeat( site, collapseWindowNs ? hash( context ) : 0 ) )
+        {
+            format( os, context );
+        }
+    }
+
+    // The emitters call sendRecord() with lambdas, each is passed as the context of a function that calls it
+    template <typename Hash, typename Format>
+    void toSink( std::ostream& os, const CallSite* site, const Hash& hash, const Format& format )
+    {
+        struct Context
+        {
+            const Hash&     hash;
+            const Format&   format;
+        } context{ hash, format };
+
+        sendRecord( os, site, 
+                    []( const void* c ) -> std::uint64_t { return static_cast<const Context*>( c )->hash(); },
+                    []( std::ostream& out, const void* c ) { static_cast<const Context*>( c )->format( out ); }, 
+                    &context );
+    }
+
+    // The signals of crashes output the crashing thread's ring (on a best effort basis:  std::cerr isn't async
+    // signal safe), then the signal's previous handler takes it
+    inline constexpr int crashSignals[]{ SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+    inline void (*previousCrashHandlers[std::size( crashSignals )])( int ){};
+
+    inline void backtraceOnCrash( int signal )
+    {
+        if ( auto ring = BacktraceRing::current() )
+        {
+            char trigger[16]{ "signal " };
+            std::to_chars( trigger + 7, trigger + sizeof trigger - 1, signal );
+            ring->flush( nullptr, trigger );
+        }
+        for ( std::size_t i = 0; i < std::size( crashSignals ); i++ )
+        {
+            if ( crashSignals[i] == signal )
+            {
+                std::signal( signal, previousCrashHandlers[i] );
+            }
+        }
+        std::raise( signal );
+    }
+
+    // Debugging version overloads (declared above)
+    inline void enableBacktrace( std::true_type, std::size_t nbrRecords )
+    {
+        static std::once_flag handlersInstalled;
+        if ( nbrRecords )
+        {
+            std::call_once( handlersInstalled, []
+            {
+                for ( std::size_t i = 0; i < std::size( crashSignals ); i++ )
+                {
+                    auto previous = std::signal( crashSignals[i], backtraceOnCrash );
+                    previousCrashHandlers[i] = previous == SIG_ERR ? SIG_DFL : previous;
+                }
+            } );
+        }
+        backtraceSize.store( nbrRecords, std::memory_order_relaxed );
+    }
+
+    inline void flushBacktrace( std::true_type )
+    {
+        BacktraceRing::local().flush( nullptr, "flushBacktrace()" );
+    }
+
+
+
+    // Filters:  a filter spec lists the call sites that are on, and can choose where the records go.  It is 
+    // compiled into the runtime switches of the call sites, so a filter costs nothing when records are emitted.
+    // The spec is a list of terms separated by commas or newlines ('#' starts a comment up to the end of the line):
+    //
+    //      net/*.cpp               the call sites in these files (see SiteSelector for the globs)
+    //      net/*.cpp:warn          ... of log level Warn or higher (trace, debug, info, warn or error)
+    //      parser.cpp:120-300      ... on these lines (or on one line, parser.cpp:120)
+    //      fn=Parser::parse        the call sites in the functions whose signature contains this
+    //      cat=net::Sockets        the call sites of this category
+    //      level=info              the call sites of log level Info or higher
+    //      -<term>                 switches the call sites of the term off rather than on
+    //      sink=<file name>        appends the records to this file (sink=stderr for std::cerr)
+    //      backtrace=<n>           keeps the last n records of each thread in memory instead (see enableBacktrace(), 
+    //                              backtrace=0 turns it off)
+    //
+    // Terms are applied in order, the last one that selects a call site decides.  If any term switches call 
+    // sites on, the call sites that no term selects are off; otherwise they are on.
+    //
+    // At startup, the spec in the environment variable DEBUGUTILS_FILTER, or in the file named by 
+    // DEBUGUTILS_FILTER_FILE, is applied.  The file is then applied again whenever it changes (see FilterWatcher).
+
+    // The sink chosen by a filter.  std::cerr is redirected to it (the same way as by DebugFileOn), while no
+    // record is being output (see sinkMutex).  Files that are replaced by another sink stay open until the end of
+    // the program, in case another thread still writes to std::cerr outside of the records.
+    class FilterSink
+    {
+        public:
+            static FilterSink& instance()
+            {
+                static FilterSink sink;
+                return sink;
+            }
+
+            void open( const std::string& name )
+            {
+                std::lock_guard lock{ sinkMutex };
+                if ( name == mName )
+                {
+                    return;
+                }
+                flushRepeats();
+                mName = name;
+                if ( name == "stderr" )
+                {
+                    restore();
+                    return;
+                }
+
+                auto file = std::make_unique<std::ofstream>( name, std::ios::app );
+                if ( *file )
+                {
+                    auto previous = std::cerr.rdbuf( file->rdbuf() );
+                    if ( !mOriginalCerrBuff )
+                    {
+                        mOriginalCerrBuff = previous;       // Save cerr buffer to restore in destructor
+                    }
+                    mFiles.push_back( std::move( file ) );
+                }
+                else
+                {
+                    // In case of error, std:cerr remains as it was
+                    std::cerr << "Unable to open debug logging file " << name << std::endl;
+                }
+            }
+
+            ~FilterSink()
+            {
+                restore();
+            }
+
+        private:
+            FilterSink() = default;
+
+            void restore()
+            {
+                if ( mOriginalCerrBuff )
+                {
+                    std::cerr.rdbuf( mOriginalCerrBuff );       // Restore cerr
+                    mOriginalCerrBuff = nullptr;
+                }
+            }
+
+            std::string                                 mName{ "stderr" };
+            std::streambuf*                             mOriginalCerrBuff{ nullptr };
+            std::vector<std::unique_ptr<std::ofstream>> mFiles;
+    };
+
+
+    class Filter
+    {
+        public:
+            // Parses a spec.  Terms that can't be parsed are reported on std::cerr and ignored.
+            explicit Filter( std::string_view spec )
+            {
+                while ( !spec.empty() )
+                {
+                    auto line = nextToken( spec, '\n' );
+                    line = line.substr( 0, line.find( '#' ) );
+                    while ( !line.empty() )
+                    {
+                        auto term = trim( nextToken( line, ',' ) );
+                        if ( !term.empty() && !parseTerm( term ) )
+                        {
+                            std::cerr << "Ignoring debug filter term " << term << std::endl;
+                            mValid = false;
+                        }
+                    }
+                }
+            }
+
+            // False if some terms were ignored
+            bool valid() const
+            {
+                return mValid;
+            }
+
+            // Switches every call site on or off, as selected by the filter, and opens its sink.  Each call site's
+            // switch is written once, so call sites that the filter leaves on are never switched off in between.
+            // Filters applied at the same time (e.g., by a FilterWatcher) are applied one after the other.
+            // Returns the number of call sites that are on.
+            std::size_t apply() const
+            {
+                static std::mutex applying;
+                std::lock_guard lock{ applying };
+
+                if ( !mSink.empty() )
+                {
+                    FilterSink::instance().open( mSink );
+                }
+                if ( mBacktrace >= 0 )
+                {
+                    enableBacktrace( std::true_type{}, static_cast<std::size_t>( mBacktrace ) );
+                }
+
+                std::vector<SiteSelector> selectors;
+                for ( auto& t : mTerms )
+                {
+                    selectors.push_back( t.selector() );
+                }
+
+                std::size_t nbrOn{ 0 };
+                for ( auto site : callSites() )
+                {
+                    bool on{ !mAllowList };
+                    for ( std::size_t i = 0; i < mTerms.size(); i++ )
+                    {
+                        if ( matches( selectors[i], site ) )
+                        {
+                            on = mTerms[i].on;
+                        }
+                    }
+                    setSiteEnabled( site, on );
+                    nbrOn += on;
+                }
+                return nbrOn;
+            }
+
+        private:
+            struct Term
+            {
+                std::string     file;
+                std::string     function;
+                std::string     category;
+                int             firstLine{ 0 };
+                int             lastLine{ INT_MAX };
+                int             minLevel{ Trace::value };
+                bool            on{ true };
+
+                SiteSelector selector() const
+                {
+                    return { file.empty() ? nullptr : file.c_str(), firstLine, lastLine, function.empty() ? nullptr : function.c_str(), 
+                             category.empty() ? nullptr : category.c_str(), minLevel };
+                }
+            };
+
+            // Removes and returns the part of s up to the first separator
+            static std::string_view nextToken( std::string_view& s, char separator )
+            {
+                auto end = s.find( separator );
+                auto token = s.substr( 0, end );
+                s.remove_prefix( end == std::string_view::npos ? s.size() : end + 1 );
+                return token;
+            }
+
+            static std::string_view trim( std::string_view s )
+            {
+                while ( !s.empty() && std::isspace( static_cast<unsigned char>( s.front() ) ) )
+                    s.remove_prefix( 1 );
+                while ( !s.empty() && std::isspace( static_cast<unsigned char>( s.back() ) ) )
+                    s.remove_suffix( 1 );
+                return s;
+            }
+
+            static bool parseLevel( std::string_view name, int& level )
+            {
+                constexpr std::string_view names[]{ "trace", "debug", "info", "warn", "error" };
+                for ( int i = 0; i < static_cast<int>( std::size( names ) ); i++ )
+                {
+                    if ( std::ranges::equal( name, names[i], []( char a, char b ) { return std::tolower( static_cast<unsigned char>( a ) ) == b; } ) )
+                    {
+                        level = i;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            static bool parseInt( std::string_view s, int& n )
+            {
+                auto [ end, ec ] = std::from_chars( s.data(), s.data() + s.size(), n );
+                return ec == std::errc{} && end == s.data() + s.size();
+            }
+
+            // A level or a line range after the last ':' of a term, with or without spaces around the ':'.  Anything 
+            // else (e.g., the '::' of a category) is part of the term.
+            static bool parseQualifier( std::string_view& term, Term& t )
+            {
+                auto colon = term.rfind( ':' );
+                if ( colon == std::string_view::npos )
+                {
+                    return true;
+                }
+                auto qualifier = trim( term.substr( colon + 1 ) );
+                auto dash = qualifier.find( '-' );
+                bool parsed = parseLevel( qualifier, t.minLevel ) 
+                    || ( dash == std::string_view::npos ? parseInt( qualifier, t.firstLine ) && parseInt( qualifier, t.lastLine )
+                                                         : parseInt( qualifier.substr( 0, dash ), t.firstLine ) && parseInt( qualifier.substr( dash + 1 ), t.lastLine ) );
+                if ( parsed )
+                {
+                    term = trim( term.substr( 0, colon ) );
+                }
+                else if ( !qualifier.empty() && std::isdigit( static_cast<unsigned char>( qualifier.front() ) ) )
+                {
+                    return false;
+                }
+                return true;
+            }
+
+            // A term is "key=value" (with or without spaces around the '='), or a file pattern, which can't contain
+            // a '='
+            bool parseTerm( std::string_view term )
+            {
+                Term t;
+                if ( term.starts_with( '-' ) )
+                {
+                    t.on = false;
+                    term = trim( term.substr( 1 ) );
+                }
+
+                if ( auto equal = term.find( '=' ); equal != std::string_view::npos )
+                {
+                    auto key = trim( term.substr( 0, equal ) );
+                    auto value = trim( term.substr( equal + 1 ) );
+                    if ( key == "sink" && t.on )
+                    {
+                        mSink = value;
+                        return !mSink.empty();
+                    }
+                    if ( key == "backtrace" && t.on )
+                    {
+                        int n{ 0 };
+                        if ( !parseInt( value, n ) || n < 0 )
+                        {
+                            return false;
+                        }
+                        mBacktrace = n;
+                        return true;
+                    }
+
+                    if ( key == "level" )
+                    {
+                        if ( !parseLevel( value, t.minLevel ) )
+                        {
+                            return false;
+                        }
+                    }
+                    else if ( key == "fn" || key == "cat" )
+                    {
+                        if ( !parseQualifier( value, t ) || value.empty() )
+                        {
+                            return false;
+                        }
+                        ( key == "fn" ? t.function : t.category ) = value;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    if ( !parseQualifier( term, t ) || term.empty() )
+                    {
+                        return false;
+                    }
+                    // A ':' left in a file pattern (other than a drive letter's) is a qualifier that couldn't be parsed
+                    if ( auto colon = term.find( ':' ); colon != std::string_view::npos && colon != 1 )
+                    {
+                        return false;
+                    }
+                    t.file = term;
+                }
+                mAllowList = mAllowList || t.on;
+                mTerms.push_back( std::move( t ) );
+                return true;
+            }
+
+            std::vector<Term>   mTerms;
+            std::string         mSink;
+            int                 mBacktrace{ -1 };       // Unchanged if negative
+            bool                mAllowList{ false };
+            bool                mValid{ true };
+    };
+
+
+    // Reads a whole filter spec file, false if it can't be read
+    inline bool readFilterFile( const char* filename, std::string& spec )
+    {
+        std::ifstream file{ filename };
+        if ( !file )
+        {
+            std::cerr << "Unable to open debug filter file " << filename << std::endl;
+            return false;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        spec = std::move( contents ).str();
+        return true;
+    }
+
+
+    // Debugging version overloads (declared above)
+    inline bool applyFilter( std::true_type, const char* spec )
+    {
+        Filter filter{ spec };
+        filter.apply();
+        return filter.valid();
+    }
+
+    inline bool applyFilterFile( std::true_type, const char* filename )
+    {
+        std::string spec;
+        return readFilterFile( filename, spec ) && applyFilter( std::true_type{}, spec.c_str() );
+    }
+
+
+#if DEBUGUTILS_INOTIFY
+
+    // Applies a filter file again whenever it is written or replaced.  A background thread waits for inotify
+    // events on the file's directory (editors often replace a file rather than write it) and reloads the file
+    // as soon as it is closed after writing or renamed into place.  The call sites are switched as the filter 
+    // is applied (see Filter::apply()), threads that are emitting records are never stopped.
+    class FilterWatcher
+    {
+        public:
+            explicit FilterWatcher( const char* filename )
+                : mFilename{ filename }
+            {
+                // Constructed before the watcher so that they are destroyed after it
+                FilterSink::instance();
+                callSites();
+
+                auto slash = mFilename.rfind( '/' );
+                std::string directory = slash == std::string::npos ? "." : mFilename.substr( 0, std::max<std::size_t>( slash, 1 ) );
+                mName = mFilename.substr( slash + 1 );
+
+                mInotify = inotify_init1( IN_CLOEXEC );
+                if ( mInotify < 0 or inotify_add_watch( mInotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO ) < 0 
+                     or pipe2( mStopPipe, O_CLOEXEC ) < 0 )
+                {
+                    std::cerr << "Unable to watch debug filter file " << mFilename << std::endl;
+                    return;
+                }
+                mThread = std::thread{ [this] { watch(); } };
+            }
+
+            ~FilterWatcher()
+            {
+                if ( mThread.joinable() )
+                {
+                    char stop{ 0 };
+                    [[maybe_unused]] auto n = write( mStopPipe[1], &stop, 1 );
+                    mThread.join();
+                }
+                for ( int fd : { mInotify, mStopPipe[0], mStopPipe[1] } )
+                {
+                    if ( fd >= 0 )
+                        close( fd );
+                }
+            }
+
+            FilterWatcher( const FilterWatcher& ) = delete;
+            FilterWatcher& operator=( const FilterWatcher& ) = delete;
+
+        private:
+            void watch()
+            {
+                alignas( inotify_event ) char events[4096];
+                pollfd fds[]{ { mInotify, POLLIN, 0 }, { mStopPipe[0], POLLIN, 0 } };
+                while ( poll( fds, 2, -1 ) >= 0 or errno == EINTR )
+                {
+                    if ( fds[1].revents )
+                    {
+                        return;
+                    }
+                    if ( !( fds[0].revents & POLLIN ) )
+                    {
+                        continue;
+                    }
+
+                    auto n = read( mInotify, events, sizeof events );
+                    bool changed{ false };
+                    for ( char* p = events; p < events + std::max<ssize_t>( n, 0 ); )
+                    {
+                        auto event = reinterpret_cast<inotify_event*>( p );
+                        changed = changed || ( event->len && mName == event->name );
+                        p += sizeof( inotify_event ) + event->len;
+                    }
+                    if ( changed )
+                    {
+                        applyFilterFile( std::true_type{}, mFilename.c_str() );
+                    }
+                }
+            }
+
+            std::string     mFilename;
+            std::string     mName;                  // File name without its directories
+            int             mInotify{ -1 };
+            int             mStopPipe[2]{ -1, -1 };
+            std::thread     mThread;
+    };
+
+    // Watches the filter file given at startup until the end of the program
+    inline void watchFilterFile( const char* filename )
+    {
+        static FilterWatcher watcher{ filename };
+    }
+
+#else
+
+    // Filter files can't be watched without inotify
+    inline void watchFilterFile( const char* ) {}
+
+#endif
+
+
+    // The filter applied at startup (see Filter), a filter file is also watched for changes
+    inline bool applyStartupFilter()
+    {
+        if ( const char* spec = std::getenv( "DEBUGUTILS_FILTER" ) )
+        {
+            return applyFilter( std::true_type{}, spec );
+        }
+        if ( const char* filename = std::getenv( "DEBUGUTILS_FILTER_FILE" ) )
+        {
+            bool applied = applyFilterFile( std::true_type{}, filename );
+            watchFilterFile( filename );
+            return applied;
+        }
+        return true;
+    }
+
+    inline const bool startupFilterApplied = applyStartupFilter();
+
+
+
+    // Reports the records suppressed by debugDedupV (defined further below)
+    inline void printSuppressedSummary();
+
+
+    // Specialization applies when debug mode is on (DebugUtilsPolicy == std::true_type)
+    // It is the only template instantiation that does anything
+    template <>
+    class DebugFileOnBase<std::true_type>
+    {
+        public:
+            DebugFileOnBase( std::true_type, const char* filename ) 
+                : mDebugLogFile{}, mOriginalCerrBuff{ nullptr }
+            {
+                open( filename );
+            }
+
+            // The file name of logDebugToFile(), deferred like the arguments of the debugging functions
+            template <typename Filename>
+            DebugFileOnBase( std::true_type, Deferred<Filename> filename ) 
+                : mDebugLogFile{}, mOriginalCerrBuff{ nullptr }
+            {
+                filename.pass( [this]( std::string_view name ) { open( name ); } );
+            }
+
+            ~DebugFileOnBase()
+            {
+                printSuppressedSummary();
+                std::cerr << "Closing the debug logging file" << std::endl;
+                if ( mOriginalCerrBuff )
+                {
+                    std::cerr.rdbuf( mOriginalCerrBuff );       // Restore cerr
+                }
+                // ofstream destructor closes the file
+            }
+
+
+        private:
+            void open( std::string_view filename )
+            {
+                auto t = std::time( nullptr );
+                char timestamp[32];
+                std::strftime( timestamp, sizeof timestamp, "%Y%m%d_%H%M%S", std::localtime( &t ) );
+                flushRepeats();
+                
+                std::string fn{ filename };
+                fn += '_';
+                fn += timestamp;
+                fn += ".log";
+                mDebugLogFile.open( fn );
+                if ( mDebugLogFile )
+                {
+                    mOriginalCerrBuff = std::cerr.rdbuf();          // Save cerr buffer to restore in destructor
+                    std::cerr.rdbuf( mDebugLogFile.rdbuf() );
+                    std::cerr << "Debug logging redirected to file " << fn << std::endl;
+                }
+                else
+                {
+                    // In case of error, std:cerr remains as it was
+                    std::cerr << "Unable to open debug logging file " << fn << std::endl;
+                }
+            }
+
+            std::ofstream       mDebugLogFile;
+            std::streambuf*     mOriginalCerrBuff;
+    };
+
+
+
+    // Following code uses template recursion on variadic function templates. 
+    // The various functions print(...) provide the base case for template recursion.
+
+    // All of the printing functions take the output stream as their first argument.  Normally this is
+    // std::cerr, but large containers are formatted into separate streams on separate threads (see below).
+
+    // The functions below handle single arguments, which provide the "base cases" for 
+    // template recursion. Base case in the context means the single argument case
+    
+    // These handle specific types of single arguments base cases
+    // A null C string prints as nullptr (inserting it would set the stream's badbit and lose the rest of the log)
+    inline void print( std::ostream& os, const char* x )  { os << ( x ? x : "nullptr" ); }
+
+    inline void print( std::ostream& os, char x )  { os << "\'" << x << "\'"; }
+
+    inline void print( std::ostream& os, bool x )  { os << (x ? "T" : "F"); }
+
+    inline void print( std::ostream& os, std::string x )  { os << "\"" << x << "\""; }
+
+    inline void print( std::ostream& os, std::vector<bool>& v )
+    { 
+        // This overload because stl optimizes vector<bool> by using
+        // _Bit_reference instead of bool to conserve space.
+        int f{ 0 };
+        os << '{';
+        for ( auto &&i : v )
+        {
+            os << (f++ ? "," : "") << ( i ? "T" : "F" );
+        }
+        os << "}";
+    }
+
+    // Helper concept/requirement processing the generic base case (C strings and std::string aren't iterables here)
+    template <typename T>
+    concept is_iterable = requires( T &&x ) { std::ranges::begin(x); std::ranges::end(x); } &&
+                            !std::is_same_v<std::remove_cvref_t<T>, std::string> &&
+                            !std::is_convertible_v<T, const char*>;
+
+    // Iterables that can't report their size (forward lists, lazy views, generators) may be infinite, 
+    // so at most this many of their elements are visited
+    inline constexpr std::size_t unsizedElementCap{ 1000 };
+
+    template <typename T>
+    constexpr std::size_t elementCap()
+    {
+        return std::ranges::sized_range<T> ? std::numeric_limits<std::size_t>::max() : unsizedElementCap;
+    }
+
+    // Declared here because printParallel() and print() call each other
+    template <typename T>
+    void print( std::ostream& os, T&& x );
+
+
+    // Random access iterables with at least this many elements are formatted in parallel
+    inline constexpr std::size_t parallelPrintThreshold{ 1 << 16 };
+
+    // Each thread formats at least this many elements (so small machines don't spawn useless threads)
+    inline constexpr std::size_t parallelPrintMinChunk{ 1 << 14 };
+
+    // Format a large random access iterable in contiguous chunks, each chunk on its own thread and into
+    // its own string stream.  The chunks are then joined in order into the output stream.  The calling 
+    // thread formats the first chunk itself.
+    template <typename T>
+    void printParallel( std::ostream& os, T&& x )
+    {
+        const std::size_t n = std::ranges::size(x);
+        const std::size_t nbrThreads = std::clamp<std::size_t>( std::thread::hardware_concurrency(), 1, n / parallelPrintMinChunk );
+        const std::size_t chunk = ( n + nbrThreads - 1 ) / nbrThreads;
+        auto first = std::ranges::begin(x);
+
+        std::vector<std::ostringstream> parts( nbrThreads );
+        auto formatChunk = [&]( std::size_t part )
+        {
+            auto& out = parts[part];
+            out.copyfmt( os );
+            for ( std::size_t ind = part * chunk; ind < std::min( n, (part + 1) * chunk ); ind++ )
+            {
+                out << ( ind ? "," : "" ), print( out, first[ind] );
+            }
+        };
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve( nbrThreads - 1 );
+            for ( std::size_t part = 1; part < nbrThreads; part++ )
+            {
+                workers.emplace_back( formatChunk, part );
+            }
+            formatChunk( 0 );
+        }   // jthread destructors join the workers here
+
+        os << "{";
+        for ( auto& part : parts )
+        {
+            os << part.view();
+        }
+        os << "}";
+    }
+
+
+    // Helper concepts for the matrix renderer:  numbers are arithmetic types that aren't printed as characters
+    // or booleans, and matrices are random access iterables of random access iterables of numbers
+    template <typename T>
+    concept is_number = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+                        !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char> && !std::is_same_v<T, wchar_t> &&
+                        !std::is_same_v<T, char8_t> && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+    template <typename T>
+    concept is_matrix = std::ranges::random_access_range<T> && std::ranges::sized_range<T> &&
+                        std::ranges::random_access_range<std::ranges::range_reference_t<T>> && 
+                        std::ranges::sized_range<std::ranges::range_reference_t<T>> &&
+                        is_number<std::remove_cvref_t<std::ranges::range_reference_t<std::ranges::range_reference_t<T>>>>;
+
+    // Matrices with more than twice this many rows (or columns) only show this many at each end 
+    inline constexpr std::size_t matrixEdge{ 8 };
+
+    // The matrix renderer formats numbers like the stream only when it has the default number format (decimal, 
+    // the general float format, and none of std::showpos, std::showpoint, std::showbase or std::uppercase)
+    inline bool hasDefaultNumberFormat( const std::ostream& os )
+    {
+        constexpr auto numberFlags = std::ios_base::basefield | std::ios_base::floatfield | std::ios_base::showpos | 
+                                     std::ios_base::showpoint | std::ios_base::showbase | std::ios_base::uppercase;
+        return ( os.flags() & numberFlags ) == std::ios_base::dec;
+    }
+
+    // Print a matrix with right aligned columns.  A pre-pass formats each visible cell exactly once 
+    // (with std::to_chars, or with a stream if it doesn't fit the buffer) into one buffer while finding the 
+    // width of each column.  The rows are then assembled from those cells into a single string that is written 
+    // out in one go.  The stream must have the default number format (see hasDefaultNumberFormat()).
+    template <typename T>
+    void printMatrix( std::ostream& os, T&& x )
+    {
+        using Number = std::remove_cvref_t<std::ranges::range_reference_t<std::ranges::range_reference_t<T>>>;
+        constexpr std::size_t ellipsis{ std::numeric_limits<std::size_t>::max() };
+        constexpr std::size_t blank{ ellipsis - 1 };
+        constexpr std::size_t edge{ matrixEdge };
+
+        const std::size_t nRows = std::ranges::size(x);
+        std::size_t nCols{ 0 };
+        for ( auto&& row : x )
+        {
+            nCols = std::max<std::size_t>( nCols, std::ranges::size(row) );
+        }
+        const std::size_t nRowSlots = nRows > 2 * edge ? 2 * edge + 1 : nRows;
+        const std::size_t nColSlots = nCols > 2 * edge ? 2 * edge + 1 : nCols;
+
+        // Map the slots (displayed positions) to row and column indices.  Long rows show their own first 
+        // and last columns around a "..." slot; short (ragged) rows leave that slot blank. 
+        auto row = [&]( std::size_t rowSlot )
+        {
+            if ( nRows <= 2 * edge || rowSlot < edge )
+                return rowSlot;
+            return rowSlot == edge ? ellipsis : nRows - ( nRowSlots - rowSlot );
+        };
+        auto column = [&]( std::size_t rowSize, std::size_t colSlot )
+        {
+            if ( nCols <= 2 * edge || colSlot < edge )
+                return colSlot;
+            if ( rowSize > 2 * edge )
+                return colSlot == edge ? ellipsis : rowSize - ( nColSlots - colSlot );
+            return colSlot == edge ? blank : colSlot - 1;
+        };
+
+        // Pre-pass:  format the visible cells and find the column widths
+        std::string cells;
+        std::vector<std::size_t> cellEnds;
+        std::vector<std::size_t> widths( nColSlots, 1 );
+        for ( std::size_t rowSlot = 0; rowSlot < nRowSlots; rowSlot++ )
+        {
+            if ( row( rowSlot ) == ellipsis )
+                continue;
+            auto&& r = std::ranges::begin(x)[row( rowSlot )];
+            const std::size_t rowSize = std::ranges::size(r);
+            for ( std::size_t colSlot = 0; colSlot < nColSlots; colSlot++ )
+            {
+                std::size_t c = column( rowSize, colSlot );
+                if ( c == ellipsis or c == blank )
+                {
+                    widths[colSlot] = std::max<std::size_t>( widths[colSlot], 3 );
+                    continue;
+                }
+                if ( c >= rowSize )
+                    break;
+
+                char buffer[64];
+                const Number value = std::ranges::begin(r)[c];
+                std::to_chars_result result;
+                if constexpr ( std::is_floating_point_v<Number> )
+                    result = std::to_chars( buffer, buffer + sizeof buffer, value, std::chars_format::general, os.precision() );
+                else
+                    result = std::to_chars( buffer, buffer + sizeof buffer, value );
+                const std::size_t start = cells.size();
+                if ( result.ec == std::errc{} )
+                {
+                    cells.append( buffer, result.ptr );
+                }
+                else                                                    // Longer than the buffer (a high precision)
+                {
+                    std::ostringstream cell;
+                    cell.precision( os.precision() );
+                    cell << value;
+                    cells += std::move( cell ).str();
+                }
+                cellEnds.push_back( cells.size() );
+                widths[colSlot] = std::max<std::size_t>( widths[colSlot], cells.size() - start );
+            }
+        }
+
+        // Assemble the rows from the formatted cells
+        const std::size_t indexWidth = std::to_string( nRows - 1 ).size();
+        std::string out{ "\n~~~~~ " + std::to_string( nRows ) + "x" + std::to_string( nCols ) + "\n" };
+        std::size_t cell{ 0 };
+        for ( std::size_t rowSlot = 0; rowSlot < nRowSlots; rowSlot++ )
+        {
+            if ( row( rowSlot ) == ellipsis )
+            {
+                out.append( indexWidth, '.' ).append( "\n" );
+                continue;
+            }
+            std::string index = std::to_string( row( rowSlot ) );
+            out.append( indexWidth - index.size(), ' ' ).append( index ).append( " [" );
+            const std::size_t rowSize = std::ranges::size( std::ranges::begin(x)[row( rowSlot )] );
+            for ( std::size_t colSlot = 0; colSlot < nColSlots; colSlot++ )
+            {
+                std::size_t c = column( rowSize, colSlot );
+                if ( c == ellipsis or c == blank )
+                {
+                    out.append( widths[colSlot] - 2, ' ' ).append( c == ellipsis ? "..." : "   " );
+                    continue;
+                }
+                if ( c >= rowSize )
+                    break;
+                const std::size_t begin = cell ? cellEnds[cell - 1] : 0;
+                const std::size_t len = cellEnds[cell++] - begin;
+                out.append( widths[colSlot] + 1 - len, ' ' ).append( cells, begin, len );
+            }
+            out += " ]\n";
+        }
+        out += "~~~~~\n";
+        os.write( out.data(), out.size() );
+    }
+
+
+    // This template handles all other single argument cases
+    template <typename T>
+    void print( std::ostream& os, T&& x )
+    {
+        if constexpr ( is_iterable<T> )                                 // Various iterables...
+        {
+            // The layout is decided from the element type, and each element is visited exactly once,
+            // so single pass ranges (input views, generators) print without being materialized 
+            auto it = std::ranges::begin(x);
+            auto last = std::ranges::end(x);
+            std::size_t count{ 0 };
+            if ( it == last )
+            {
+                os << "{}";
+            }
+            else if constexpr ( is_iterable<std::ranges::range_reference_t<T>> )   // Iterable inside Iterable
+            {
+                if constexpr ( is_matrix<T> )                           // ... of numbers, as a matrix
+                {
+                    if ( hasDefaultNumberFormat( os ) )
+                    {
+                        printMatrix( os, x );
+                        return;
+                    }
+                }
+
+                std::size_t w{ 2 };
+                if constexpr ( std::ranges::sized_range<T> )
+                {
+                    w = std::to_string( std::ranges::size(x) - 1 ).size() + 1;
+                }
+                os << "\n~~~~~\n";
+                for ( ; it != last && count < elementCap<T>(); ++it )
+                {
+                    std::string index = std::to_string( count++ );
+                    index.resize( std::max( w, index.size() ), ' ' );           // Left aligned in a column w wide
+                    os << index, print( os, *it ), os << "\n";
+                }
+                os << ( it != last ? "...\n" : "" ) << "~~~~~\n";
+            }
+            else                                                        // A plain, normal Iterable
+            {
+                if constexpr ( std::ranges::random_access_range<T> && std::ranges::sized_range<T> )
+                {
+                    if ( static_cast<std::size_t>( std::ranges::size(x) ) >= parallelPrintThreshold )     // A very large one
+                    {
+                        printParallel( os, x );
+                        return;
+                    }
+                }
+
+                os << "{";
+                for ( ; it != last && count < elementCap<T>(); ++it )
+                {
+                    os << ( count++ ? "," : "" ), print( os, *it );
+                }
+                os << ( it != last ? ",...}" : "}" );
+            }
+        }
+        else if constexpr ( requires { x.pop(); } )                     // Stacks, Priority Queues, Queues 
+        {
+            auto temp{ x };
+            int f{ 0 };
+            os << "{";
+            if constexpr ( requires { x.top(); } )
+            {            
+                while ( !temp.empty() )
+                    os << ( f++ ? "," : "" ), print( os, temp.top() ), temp.pop();
+            }
+            else
+            {
+                while ( !temp.empty() )
+                    os << ( f++ ? "," : "" ), print( os, temp.front() ), temp.pop();
+            }
+            os << "}";
+        }
+        else if constexpr ( requires { x.first; x.second; } )           // Pair 
+        {
+            os << '(', print( os, x.first ), os << ',', print( os, x.second ), os << ')';
+        }
+        else if constexpr ( requires { get<0>(x); } )                   // Tuple 
+        {
+            int f{ 0 };
+            os << '(', apply( [&os, &f](auto... args) { (( os << (f++ ? "," : ""), print( os, args ) ), ...); }, x );
+            os << ')';
+        }
+        else if constexpr ( std::is_same_v<std::remove_cvref_t<T>, char*> )   // Mutable C strings
+        {
+            print( os, static_cast<const char*>( x ) );
+        }
+        else
+        {
+            os << x;                                                    // Anything else
+        }
+    }
+
+
+    // Length of the first name in the comma separated list of names (commas inside brackets don't count)
+    inline int nameLength( const char* names )
+    {
+        int i{ 0 };
+        for ( int bracket = 0; names[i] != '\0' and ( names[i] != ',' or bracket > 0 ); i++ )
+        {
+            if ( names[i] == '(' or names[i] == '<' or names[i] == '{' )
+                bracket++;
+            else if ( names[i] == ')' or names[i] == '>' or names[i] == '}' )
+                bracket--;
+        }
+        return i;
+    }
+
+
+    // Hashing is used by the modes that only print when something changed, and to collapse repeated records.  
+    // It follows the same template recursion as print(), but never formats anything unless the type offers no 
+    // other way to see its value.
+
+    inline std::uint64_t hashCombine( std::uint64_t seed, std::uint64_t h )
+    {
+        return ( seed ^ h ) * 0x100000001b3ULL + ( seed >> 29 );
+    }
+
+    // Fast non-cryptographic hash of a block of memory.  The bulk of the data is consumed 32 bytes at a time 
+    // by four independent lanes (so the loop pipelines and vectorizes), then the lanes and the tail are mixed.
+    inline std::uint64_t hashBytes( const void* data, std::size_t len )
+    {
+        constexpr std::uint64_t p1{ 0x9e3779b185ebca87ULL };
+        constexpr std::uint64_t p2{ 0xc2b2ae3d27d4eb4fULL };
+        auto bytes = static_cast<const unsigned char*>( data );
+
+        std::uint64_t lanes[4]{ p1 + p2, p2, 0, 0 - p1 };
+        std::size_t i{ 0 };
+        for ( ; i + 32 <= len; i += 32 )
+        {
+            std::uint64_t words[4];
+            std::memcpy( words, bytes + i, 32 );
+            for ( int k = 0; k < 4; k++ )
+            {
+                lanes[k] = std::rotl( lanes[k] + words[k] * p2, 31 ) * p1;
+            }
+        }
+
+        std::uint64_t h = std::rotl( lanes[0], 1 ) + std::rotl( lanes[1], 7 ) + std::rotl( lanes[2], 12 ) + std::rotl( lanes[3], 18 ) + len;
+        for ( ; i < len; i++ )
+        {
+            h = ( h ^ bytes[i] ) * 0x100000001b3ULL;
+        }
+        h ^= h >> 33;
+        h *= p2;
+        h ^= h >> 29;
+        return h;
+    }
+
+    // Helper concept for contiguous data that can be hashed as raw bytes (no padding, no floating point)
+    template <typename T>
+    concept is_contiguous_bytes = std::ranges::contiguous_range<T> && std::ranges::sized_range<T> &&
+                                    std::has_unique_object_representations_v<std::ranges::range_value_t<T>>;
+
+    // Helper concept for the arguments that can be hashed before they are printed:  input ranges can only be 
+    // iterated once, and some views can't be iterated when they are const
+    template <typename T>
+    concept is_rehashable = !std::ranges::range<T&> || std::ranges::forward_range<const T&>;
+
+    template <typename T>
+    std::uint64_t hashValue( const T& x )
+    {
+        if constexpr ( std::is_same_v<std::remove_cv_t<T>, const char*> || std::is_same_v<std::remove_cv_t<T>, char*> )
+        {
+            return x ? std::hash<std::string_view>{}( x ) : 0x6e756c6cULL;              // C strings, printed as strings
+        }
+        else if constexpr ( requires { std::hash<std::remove_cvref_t<T>>{}( x ); } ) // Scalars, strings, ...
+        {
+            return std::hash<std::remove_cvref_t<T>>{}( x );
+        }
+        else if constexpr ( is_contiguous_bytes<const T&> )                             // Vectors, arrays, spans of plain data
+        {
+            return hashBytes( std::ranges::data( x ), std::ranges::size( x ) * sizeof( std::ranges::range_value_t<const T&> ) );
+        }
+        else if constexpr ( is_iterable<const T&> )                                     // Various iterables...
+        {
+            std::uint64_t h{ 0xcbf29ce484222325ULL };
+            std::size_t count{ 0 };
+            for ( auto it = std::ranges::begin(x); it != std::ranges::end(x) && count++ < elementCap<const T&>(); ++it )
+            {
+                h = hashCombine( h, hashValue( *it ) );
+            }
+            return h;
+        }
+        else if constexpr ( requires ( std::remove_cvref_t<T>& t ) { t.pop(); } )      // Stacks, Priority Queues, Queues
+        {
+            std::uint64_t h{ 0xcbf29ce484222325ULL };
+            auto temp{ x };
+            while ( !temp.empty() )
+            {
+                if constexpr ( requires { temp.top(); } )
+                    h = hashCombine( h, hashValue( temp.top() ) );
+                else
+                    h = hashCombine( h, hashValue( temp.front() ) );
+                temp.pop();
+            }
+            return h;
+        }
+        else if constexpr ( requires { x.first; x.second; } )                           // Pair
+        {
+            return hashCombine( hashValue( x.first ), hashValue( x.second ) );
+        }
+        else if constexpr ( requires { get<0>(x); } )                                   // Tuple
+        {
+            std::uint64_t h{ 0xcbf29ce484222325ULL };
+            apply( [&h](auto&... args) { (( h = hashCombine( h, hashValue( args ) ) ), ...); }, x );
+            return h;
+        }
+        else                                                                            // Anything else
+        {
+            std::ostringstream oss;
+            print( oss, x );
+            return std::hash<std::string_view>{}( oss.view() );
+        }
+    }
+
+
+
+    // Type erased argument:  the address of an argument and the function that formats its type.  The 
+    // variadic front end only builds an array of these, so each argument type instantiates one formatter 
+    // however many different argument lists it appears in.
+    struct ArgRef
+    {
+        const void*     value;
+        void            (*format)( std::ostream&, const void* );
+        std::uint64_t   (*hash)( const void* );                     // nullptr if it can't be hashed (see is_rehashable)
+    };
+
+    // Formatter of arguments of type T (constness included, non-const ranges may not be const iterable)
+    template <typename T>
+    void formatArg( std::ostream& os, const void* value )
+    {
+        print( os, *static_cast<T*>( const_cast<void*>( value ) ) );
+    }
+
+    template <typename T>
+    std::uint64_t hashArg( const void* value )
+    {
+        return hashValue( *static_cast<const T*>( value ) );
+    }
+
+    template <typename T>
+    ArgRef argRef( T& x )
+    {
+        if constexpr ( is_rehashable<T> )
+            return { std::addressof( x ), &formatArg<T>, &hashArg<T> };
+        else
+            return { std::addressof( x ), &formatArg<T>, nullptr };
+    }
+
+    // Hash of the arguments of a record, 0 if one of them can't be hashed (the record is never collapsed)
+    inline std::uint64_t recordHash( const ArgRef* args, std::size_t nbrArgs )
+    {
+        std::uint64_t h{ 0xcbf29ce484222325ULL };
+        for ( std::size_t k = 0; k < nbrArgs; k++ )
+        {
+            if ( !args[k].hash )
+                return 0;
+            h = hashCombine( h, args[k].hash( args[k].value ) );
+        }
+        return h;
+    }
+
+    // The one emitter of the records of debugPrinterV().  The emitting code is out of line and cold (moved 
+    // away from the hot code, e.g., to .text.unlikely) so that it doesn't take up the caller's instruction 
+    // cache or registers.  A record identical to the previous record is only counted (see RepeatCollapser).
+    [[gnu::cold, gnu::noinline]] inline void emitRecord( std::ostream& os, const CallSite* site, const ArgRef* args, std::size_t nbrArgs )
+    {
+        toSink( os, site, [=] { return recordHash( args, nbrArgs ); }, [=]( std::ostream& out )
+        {
+            out << site->filename << "(" << site->lineNbr << ") [ ";
+            const char* names = site->names;
+            for ( std::size_t k = 0; k < nbrArgs; k++ )
+            {
+                int i = nameLength( names );
+                out.write( names, i ) << " = ";
+                args[k].format( out, args[k].value );
+                out << ( k + 1 < nbrArgs ? " ||" : " ]\n" );
+                names += i + 1;
+            }
+        } );
+    }
+
+    // Arguments that are cheap to copy are passed to the out of line code by value, so the caller doesn't 
+    // need their address and can keep them in registers.  Anything else is passed by reference.
+    template <typename T>
+    concept is_cheap_copy = std::is_trivially_copyable_v<std::remove_cvref_t<T>> && !std::is_array_v<std::remove_cvref_t<T>> &&
+                            !std::is_volatile_v<std::remove_reference_t<T>> && sizeof( std::remove_cvref_t<T> ) <= 2 * sizeof( void* ) &&
+                            alignof( std::remove_cvref_t<T> ) <= alignof( std::max_align_t );
+
+    template <typename T>
+    using PassArg = std::conditional_t<is_cheap_copy<T>, std::remove_cvref_t<T>, T&&>;
+
+    // Storage for an argument passed by value, in the frame of the call site
+    struct alignas( std::max_align_t ) ArgValue
+    {
+        unsigned char   bytes[2 * sizeof( void* )];
+    };
+
+    // Type erases one argument out of line:  an argument passed by value is copied to its storage first (with
+    // memcpy, which creates the trivially copyable value there:  a placement new doesn't resolve in code importing
+    // the module with GCC 12).  There is one of these per argument type, however many argument lists it appears in.
+    template <typename A>
+    [[gnu::cold, gnu::noinline]] void eraseArg( ArgRef& ref, ArgValue& storage, PassArg<A> x )
+    {
+        if constexpr ( is_cheap_copy<A> )
+        {
+            std::memcpy( storage.bytes, &x, sizeof( x ) );
+            ref = argRef( *std::launder( reinterpret_cast<std::remove_cvref_t<A>*>( storage.bytes ) ) );
+        }
+        else
+            ref = argRef( x );
+    }
+
+    // Builds the array of type erased arguments of debugPrinterV() (the template arguments are the types deduced 
+    // by debugPrinterV()).  It only calls eraseArg() for each argument and then the shared emitRecord(), so the
+    // code of an argument list is a few calls at its call site.
+    template <typename... A>
+    [[gnu::always_inline]] inline void emitRecordV( const CallSite* site, PassArg<A>... args )
+    {
+        ArgRef refs[sizeof...( A )];
+        ArgValue values[sizeof...( A )];
+        std::size_t k{ 0 };
+        ( ( eraseArg<A>( refs[k], values[k], std::forward<PassArg<A>>( args ) ), k++ ), ... );
+        emitRecord( std::cerr, site, refs, sizeof...( A ) );
+    }
+
+
+
+    // This a version of the variadic function for plain arrays 
+    // Pass using macros as debugArr( array1Ptr, N1, array2Ptr, N2, array3Ptr, N3 )
+    // It works the same way as printer()
+    template <typename T, typename... V>
+    void printerArr( std::ostream& os, const char* names, T arr[], size_t n, V... tail )
+    {
+        size_t i = 0;
+        for ( ; names[i] and names[i] != ','; i++ )
+            os << names[i];
+        for ( i++; names[i] and names[i] != ','; i++ )
+            ;
+        os << " = ";
+        if constexpr ( is_iterable<T&> )
+        {
+            print( os, std::span<T>( arr, n ) );                   // 2D arrays print as matrices
+        }
+        else if ( n >= parallelPrintThreshold )
+        {
+            printParallel( os, std::span<T>( arr, n ) );
+        }
+        else
+        {
+            os << "{";
+            for ( size_t ind = 0; ind < n; ind++ )
+                os << ( ind ? "," : "" ), print( os, arr[ind] );
+            os << "}";
+        }
+        if constexpr ( sizeof...( tail ) )
+            os << " ||", printerArr( os, names + i + 1, tail... );
+        else
+            os << " ]\n";
+    }
+
+
+
+    // Diff mode: each call site remembers a hash of every argument (and of every element of iterable
+    // arguments) from its previous hit, and then prints only what changed since that previous hit.
+
+
+    // Per call site state for diff mode.  The template argument is the address of the call site's 
+    // descriptor (see CallSite), so each call site gets its own copy of these static members.
+    template <const CallSite* Site>
+    struct DiffState
+    {
+        static inline std::mutex                                mutex{};
+        static inline bool                                      hit{ false };
+        static inline std::vector<std::vector<std::uint64_t>>   hashes{};
+    };
+
+
+    // Print the diff of a single argument against its hashes from the previous hit and replace those hashes.  
+    // Iterables print only their changed ("[k]=x"), added ("+[k]=x") and removed ("-[k..m]") elements. 
+    // Everything else prints only if its value changed.  Returns true if anything was printed.
+    template <typename T>
+    bool printDiff( std::ostream& os, const char* separator, std::string_view name, T&& x, std::vector<std::uint64_t>& prev, bool firstHit )
+    {
+        static_assert( is_rehashable<std::remove_reference_t<T>>, "debugDiffV() can't diff a range that can only be iterated once" );
+        std::vector<std::uint64_t> curr;
+        bool changed{ firstHit };
+        if constexpr ( is_iterable<T> )
+        {
+            std::ostringstream changes;
+            changes.copyfmt( os );
+            std::size_t k{ 0 };
+            for ( auto it = std::ranges::begin(x); it != std::ranges::end(x) && k < elementCap<T>(); ++it )
+            {
+                auto&& i = *it;
+                curr.push_back( hashValue( i ) );
+                if ( !firstHit && ( k >= prev.size() || curr[k] != prev[k] ) )
+                {
+                    changes << ( changed ? "," : "" ) << ( k >= prev.size() ? "+[" : "[" ) << k << "]=", print( changes, i );
+                    changed = true;
+                }
+                k++;
+            }
+            if ( !firstHit && k < prev.size() )
+            {
+                changes << ( changed ? "," : "" ) << "-[" << k;
+                if ( prev.size() - k > 1 )
+                    changes << ".." << prev.size() - 1;
+                changes << "]";
+                changed = true;
+            }
+            if ( firstHit )
+                os << separator << name << " = ", print( os, x );
+            else if ( changed )
+                os << separator << name << " ~ {" << changes.view() << "}";
+        }
+        else
+        {
+            curr.push_back( hashValue( x ) );
+            changed = changed || prev.size() != 1 || prev[0] != curr[0];
+            if ( changed )
+                os << separator << name << " = ", print( os, std::forward<T>( x ) );
+        }
+        prev = std::move( curr );
+        return changed;
+    }
+
+
+    // This is the variadic function that drives the template recursion for diff mode:  it prints each argument
+    // with its name, like emitRecord(), except that unchanged arguments are skipped
+    template <typename T, typename... V>
+    bool printerDiffV( std::ostream& os, const char* names, std::vector<std::uint64_t>* prev, bool firstHit, bool anyPrinted, T&& head, V&&... tail )
+    {
+        int i = nameLength( names );
+        std::string_view name{ names, static_cast<std::size_t>( i ) };
+        name.remove_prefix( std::min( name.find_first_not_of( ' ' ), name.size() ) );
+        anyPrinted = printDiff( os, anyPrinted ? " || " : "", name, std::forward<T>( head ), *prev, firstHit ) || anyPrinted;
+        if constexpr ( sizeof...(tail) )
+        {
+            return printerDiffV( os, names + i + 1, prev + 1, firstHit, anyPrinted, std::forward<V>( tail )... );
+        }
+        else
+        {
+            return anyPrinted;
+        }
+    }
+
+
+
+    // Dedup mode: each call site remembers one hash of all its arguments from its previous hit.  When 
+    // the hash is unchanged the record is counted but neither formatted nor output.  The counts are
+    // reported by printSuppressedSummary(), which runs when the debug log file closes and at exit.
+
+    // Registry of the call sites that have suppressed records
+    class SuppressedRegistry
+    {
+        public:
+            struct Entry
+            {
+                const CallSite*             site;
+                std::atomic<std::size_t>*   count;
+            };
+
+            static SuppressedRegistry& instance()
+            {
+                static SuppressedRegistry registry;
+                return registry;
+            }
+
+            void add( const CallSite* site, std::atomic<std::size_t>* count )
+            {
+                std::lock_guard lock{ mMutex };
+                mEntries.push_back( { site, count } );
+            }
+
+            void printSummary()
+            {
+                std::lock_guard lock{ mMutex };
+                for ( auto& e : mEntries )
+                {
+                    if ( auto n = e.count->exchange( 0 ) )
+                    {
+                        std::cerr << e.site->filename << "(" << e.site->lineNbr << "): suppressed " << n << " identical records" << std::endl;
+                    }
+                }
+            }
+
+            ~SuppressedRegistry()
+            {
+                printSummary();
+            }
+
+        private:
+            SuppressedRegistry() = default;
+
+            std::mutex          mMutex;
+            std::vector<Entry>  mEntries;
+    };
+
+    inline void printSuppressedSummary()
+    {
+        flushRepeats();
+        SuppressedRegistry::instance().printSummary();
+    }
+
+
+    // Per call site state for dedup mode (see DiffState)
+    template <const CallSite* Site>
+    struct DedupState
+    {
+        static inline std::once_flag                registered{};
+        static inline std::atomic<std::uint64_t>    lastHash{ 0 };
+        static inline std::atomic<std::size_t>      suppressed{ 0 };
+    };
+
+
+
+    // Gates (see RateLimit, FirstN, EveryN and EveryT).  The state of each call site's gate is on its own cache line, so the gates of 
+    // call sites hit by different threads don't slow each other down.
+    inline constexpr std::size_t cacheLineSize{ 64 };
+
+    // Reports the records a gate suppressed, before the next record that gets through
+    [[gnu::cold, gnu::noinline]] inline void reportGated( const CallSite* site, std::size_t n, const char* gate )
+    {
+        toSink( std::cerr, site, [] { return std::uint64_t{ 0 }; }, [=]( std::ostream& os )
+        {
+            os << site->filename << "(" << site->lineNbr << "): " << gate << ", suppressed " << n << " records\n";
+        } );
+    }
+
+    inline std::int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+
+
+    // Repeated records:  the sink remembers the call site and the hash of the arguments of the last record.  A 
+    // record of the same call site with the same hash is only counted, it is neither formatted nor output.  The 
+    // count is output as "file(line): repeated N times over T ms" when a different record comes, when the 
+    // repeats have gone on for DEBUGUTILS_COLLAPSE_MS (the record is then output again), when the debug log file 
+    // closes and at exit.
+    class RepeatCollapser
+    {
+        public:
+            static RepeatCollapser& instance()
+            {
+                static RepeatCollapser collapser;
+                return collapser;
+            }
+
+            // A hash of 0 is never a repeat (the record couldn't be hashed, or collapsing is off)
+            bool isRepeat( const CallSite* site, std::uint64_t hash )
+            {
+                std::int64_t now = hash ? nowNs() : 0;
+                std::lock_guard lock{ mMutex };
+                if ( hash && site == mSite && hash == mHash && now - mFirst < collapseWindowNs )
+                {
+                    mRepeats++;
+                    mLast = now;
+                    return true;
+                }
+                report();
+                mSite = site;
+                mHash = hash;
+                mFirst = mLast = now;
+                return false;
+            }
+
+            void flush()
+            {
+                std::lock_guard lock{ mMutex };
+                report();
+                mSite = nullptr;
+            }
+
+            ~RepeatCollapser()
+            {
+                report();
+            }
+
+        private:
+            RepeatCollapser() = default;
+
+            void report()
+            {
+                if ( mRepeats )
+                {
+                    auto us = ( mLast - mFirst ) / 1000;
+                    char fraction[]{ '.', char( '0' + us / 100 % 10 ), char( '0' + us / 10 % 10 ), char( '0' + us % 10 ), '\0' };
+                    std::cerr << mSite->filename << "(" << mSite->lineNbr << "): repeated " << mRepeats << " times over " 
+                              << us / 1000 << fraction << " ms\n";
+                    mRepeats = 0;
+                }
+            }
+
+            std::mutex          mMutex;
+            const CallSite*     mSite{ nullptr };
+            std::uint64_t       mHash{ 0 };
+            std::int64_t        mFirst{ 0 };
+            std::int64_t        mLast{ 0 };
+            std::size_t         mRepeats{ 0 };
+    };
+
+    inline bool isRepeat( const CallSite* site, std::uint64_t hash )
+    {
+        return collapseWindowNs > 0 && RepeatCollapser::instance().isRepeat( site, hash );
+    }
+
+    inline void flushRepeats()
+    {
+        RepeatCollapser::instance().flush();
+    }
+
+
+    // Rate limit state, the time (in ns) at which the call site's bucket of records is full again.  A record gets 
+    // through if the bucket isn't more than burst - 1 records from full (the generic cell rate algorithm, which
+    // is a token bucket that needs only one atomic).
+    template <const CallSite* Site>
+    struct RateLimitState
+    {
+        struct alignas( cacheLineSize ) Counters
+        {
+            std::atomic<std::int64_t>   full{ 0 };
+            std::atomic<std::size_t>    suppressed{ 0 };
+        };
+
+        static inline Counters counters{};
+    };
+
+    // A rate of 0 records per second (or less, or NaN) lets nothing through, a burst below 1 (or NaN) is 1.  The 
+    // interval and tolerance are capped (at about 30 years) so that tiny rates and huge bursts don't overflow.
+    template <const CallSite* Site>
+    bool gatePasses( const RateLimit& limit )
+    {
+        auto& counters = RateLimitState<Site>::counters;
+        if ( !( limit.perSecond > 0 ) )
+        {
+            counters.suppressed.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+        constexpr double maxNs{ 1e18 };
+        std::int64_t now = nowNs();
+        double intervalNs = std::min( 1e9 / limit.perSecond, maxNs );
+        auto interval = static_cast<std::int64_t>( intervalNs );
+        double extraRecords = limit.burst > 1 ? limit.burst - 1 : 0;
+        auto tolerance = static_cast<std::int64_t>( std::min( extraRecords * intervalNs, maxNs ) );
+
+        std::int64_t full = counters.full.load( std::memory_order_relaxed );
+        std::int64_t next;
+        do
+        {
+            std::int64_t start = std::max( full, now );
+            if ( start - now > tolerance )
+            {
+                counters.suppressed.fetch_add( 1, std::memory_order_relaxed );
+                return false;
             }
+            next = start + interval;
+        } while ( !counters.full.compare_exchange_weak( full, next, std::memory_order_relaxed ) );
+
+        if ( auto n = counters.suppressed.exchange( 0, std::memory_order_relaxed ) )
+        {
+            reportGated( Site, n, "rate limited" );
+        }
+        return true;
+    }
+
+
+    // Hit counter of a call site, for FirstN and EveryN
+    template <const CallSite* Site>
+    struct HitCounter
+    {
+        struct alignas( cacheLineSize ) Counter
+        {
+            std::atomic<std::uint64_t>  hits{ 0 };
+        };
+
+        static inline Counter counter{};
+    };
+
+    template <const CallSite* Site>
+    bool gatePasses( const FirstN& first )
+    {
+        // Once the first n hits are through, the counter is only read (it stays in every thread's cache)
+        auto& hits = HitCounter<Site>::counter.hits;
+        return hits.load( std::memory_order_relaxed ) < first.n && hits.fetch_add( 1, std::memory_order_relaxed ) < first.n;
+    }
+
+    template <const CallSite* Site>
+    bool gatePasses( const EveryN& every )
+    {
+        return HitCounter<Site>::counter.hits.fetch_add( 1, std::memory_order_relaxed ) % std::max<std::uint64_t>( every.n, 1 ) == 0;
+    }
+
+
+    // Time (in ns) of the last hit of a call site that got through, for EveryT
+    template <const CallSite* Site>
+    struct LastHitTime
+    {
+        static constexpr std::int64_t never{ std::numeric_limits<std::int64_t>::min() };
+
+        struct alignas( cacheLineSize ) Time
+        {
+            std::atomic<std::int64_t>   ns{ never };
+        };
+
+        static inline Time last{};
+    };
+
+    template <const CallSite* Site, typename Duration>
+    bool gatePasses( const EveryT<Duration>& every )
+    {
+        auto& last = LastHitTime<Site>::last.ns;
+        std::int64_t now = nowNs();
+        std::int64_t previous = last.load( std::memory_order_relaxed );
+        if ( previous != LastHitTime<Site>::never && now - previous < std::chrono::duration_cast<std::chrono::nanoseconds>( every.interval ).count() )
+        {
+            return false;
+        }
+        // Only one of the threads that hit the call site at the same time gets through
+        return last.compare_exchange_strong( previous, now, std::memory_order_relaxed );
+    }
+
+
+
+    // Watchpoints:  the shadow of a watched scalar is a copy of it, when it fits in a lock-free atomic.  Anything
+    // else is shadowed by its hash (see hashValue()).  debugWatchPrinterV() shadows the result of its predicate.
+    template <typename T>
+    concept is_shadow_copied = std::is_scalar_v<T> && std::atomic<T>::is_always_lock_free;
+
+    template <typename T>
+    struct ShadowOf
+    {
+        using type = std::uint64_t;
+    };
+
+    template <typename T>
+        requires is_shadow_copied<T>
+    struct ShadowOf<T>
+    {
+        using type = T;
+    };
+
+    template <typename T>
+    auto shadowOf( const T& x )
+    {
+        if constexpr ( is_shadow_copied<T> )
+            return x;
+        else
+            return hashValue( x );
+    }
+
+    // Floating point shadows are compared bit for bit, like compare_exchange does (so NaN is equal to itself)
+    template <typename S>
+    bool sameShadow( S a, S b )
+    {
+        if constexpr ( std::is_floating_point_v<S> )
+            return std::memcmp( &a, &b, sizeof( S ) ) == 0;
+        else
+            return a == b;
+    }
+
+    // Shadow of a call site's watched variable (see DiffState).  Until the first hit the shadow is a
+    // value-initialized S, which is never compared.
+    template <const CallSite* Site, typename S>
+    struct WatchState
+    {
+        struct alignas( cacheLineSize ) Shadow
+        {
+            std::atomic<S>      value{};
+            std::atomic<bool>   hit{ false };
+        };
+
+        static inline Shadow shadow{};
+    };
+
+    // Updates the shadow of a call site, out of line and cold.  Only one of the threads that see the same change
+    // at the same time updates the shadow, and gets true.
+    template <const CallSite* Site, typename S>
+    [[gnu::cold, gnu::noinline]] bool updateShadow( S previous, S now )
+    {
+        auto& shadow = WatchState<Site, S>::shadow;
+        bool firstHit = !shadow.hit.exchange( true, std::memory_order_relaxed );
+        return shadow.value.compare_exchange_strong( previous, now, std::memory_order_relaxed ) || firstHit;
+    }
+
+    // The shadow of the call site is changed to now, returns true if it was changed (always on the first hit)
+    template <const CallSite* Site, typename S>
+    bool shadowChanged( S now )
+    {
+        auto& shadow = WatchState<Site, S>::shadow;
+        S previous = shadow.value.load( std::memory_order_relaxed );
+        if ( !sameShadow( previous, now ) | !shadow.hit.load( std::memory_order_relaxed ) ) [[unlikely]]
+        {
+            return updateShadow<Site>( previous, now );
+        }
+        return false;
+    }
+
+
+
+    // The debugging versions of the functions actually called by user code (declared above)
+
+
+    //*** debugPrinterV() variants
+
+    // Debugging version overload
+    template <typename Args>
+    void debugPrinterV( std::true_type, const CallSite* site, Deferred<Args> args )
+    {
+        if ( siteEnabled( site ) )
+        {
+            args.pass( [site]( auto&&... x ) [[gnu::always_inline]] { emitRecordV<decltype( x )...>( site, std::forward<decltype( x )>( x )... ); } );
+        }
+    }
+
+
+    //*** debugPrinterArr() variants
+
+    // Hash of the arrays of a record of debugPrinterArr() (see recordHash())
+    template <typename T, typename... V>
+    std::uint64_t arrHash( T arr[], size_t n, V... tail )
+    {
+        std::uint64_t h = hashValue( std::span<T>( arr, n ) );
+        if constexpr ( sizeof...( tail ) )
+            h = hashCombine( h, arrHash( tail... ) );
+        return h;
+    }
+
+    // The emitter of the records of debugPrinterArr(), out of line and cold like emitRecord()
+    template <typename T, typename... V>
+    [[gnu::cold, gnu::noinline]] void emitRecordArr( const CallSite* site, T arr[], size_t n, V... tail )
+    {
+        toSink( std::cerr, site, [=] { return arrHash( arr, n, tail... ); }, [=]( std::ostream& os )
+        {
+            os << site->filename << "(" << site->lineNbr << ") [ ", printerArr( os, site->names, arr, n, tail... );
+        } );
+    }
+
+    // Debugging version overload
+    template <typename Args>
+    void debugPrinterArr( std::true_type, const CallSite* site, Deferred<Args> args )
+    {
+        if ( siteEnabled( site ) )
+        {
+            args.pass( [site]( auto&&... x ) { emitRecordArr( site, x... ); } );
+        }
+    }
+
+
+    //*** debugDiffPrinterV() variants
+
+    // Emits the diff of the arguments against the previous hit of the call site
+    template <const CallSite* Site, typename T, typename... V>
+    void emitDiffV( T&& head, V&&... tail )
+    {
+        std::lock_guard lock{ DiffState<Site>::mutex };
+        auto& hashes = DiffState<Site>::hashes;
+        hashes.resize( 1 + sizeof...(tail) );
+        bool firstHit = !DiffState<Site>::hit;
+        DiffState<Site>::hit = true;
+
+        // Nothing at all is output if nothing changed
+        std::ostringstream record;
+        record.copyfmt( std::cerr );
+        if ( printerDiffV( record, Site->names, hashes.data(), firstHit, false, std::forward<T>( head ), std::forward<V>( tail )... ) )
+        {
+            toSink( std::cerr, Site, [] { return std::uint64_t{ 0 }; }, [&]( std::ostream& os )
+            {
+                os << Site->filename << "(" << Site->lineNbr << ") [ " << record.view() << " ]\n";
+            } );
+        }
+    }
+
+    // Debugging version overload
+    template <const CallSite* Site, typename Args>
+    void debugDiffPrinterV( std::true_type, Deferred<Args> args )
+    {
+        if ( siteEnabled( Site ) )
+        {
+            args.pass( []( auto&&... x ) { emitDiffV<Site>( std::forward<decltype( x )>( x )... ); } );
+        }
+    }
+
+
+    //*** debugDedupPrinterV() variants
+
+    // Emits the record unless it is the same as the previous hit of the call site (compared by hash)
+    template <const CallSite* Site, typename T, typename... V>
+    void emitDedupV( T&& head, V&&... tail )
+    {
+        static_assert( ( is_rehashable<std::remove_reference_t<T>> && ... && is_rehashable<std::remove_reference_t<V>> ), 
+                       "debugDedupV() can't hash a range that can only be iterated once before printing it" );
+        bool firstHit{ false };
+        std::call_once( DedupState<Site>::registered, [&] {
+            firstHit = true;
+            SuppressedRegistry::instance().add( Site, &DedupState<Site>::suppressed );
+        } );
+
+        std::uint64_t h = hashValue( head );
+        ( ( h = hashCombine( h, hashValue( tail ) ) ), ... );
+        if ( DedupState<Site>::lastHash.exchange( h, std::memory_order_relaxed ) == h && !firstHit )
+        {
+            DedupState<Site>::suppressed.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        }
+        emitRecordV<T, V...>( Site, std::forward<T>( head ), std::forward<V>( tail )... );
+    }
+
+    // Debugging version overload
+    template <const CallSite* Site, typename Args>
+    void debugDedupPrinterV( std::true_type, Deferred<Args> args )
+    {
+        if ( siteEnabled( Site ) )
+        {
+            args.pass( []( auto&&... x ) { emitDedupV<Site>( std::forward<decltype( x )>( x )... ); } );
+        }
+    }
+
+
+    //*** debugOnChangePrinterV() and debugWatchPrinterV() variants
+
+    // Debugging version overloads.  A hit that changes nothing costs the shadow's load and compare (and the
+    // predicate, or the hash of a variable that isn't a scalar):  the record is emitted out of line.
+    template <const CallSite* Site, typename Args>
+    void debugOnChangePrinterV( std::true_type, Deferred<Args> args )
+    {
+        if ( siteEnabled( Site ) )
+        {
+            args.pass( []( auto&& x )
+            {
+                static_assert( is_rehashable<std::remove_reference_t<decltype( x )>>, "debugOnChange() can't watch a range that can only be iterated once" );
+                if ( shadowChanged<Site>( shadowOf( x ) ) )
+                {
+                    emitRecordV<decltype( x )>( Site, std::forward<decltype( x )>( x ) );
+                }
+            } );
+        }
+    }
+
+    template <const CallSite* Site, typename Args>
+    void debugWatchPrinterV( std::true_type, Deferred<Args> args )
+    {
+        if ( siteEnabled( Site ) )
+        {
+            args.pass( []( auto&& x, auto&& predicate )
+            {
+                bool holds = static_cast<bool>( predicate( std::as_const( x ) ) );
+                if ( shadowChanged<Site>( holds ) )
+                {
+                    emitRecordV<decltype( x ), bool>( Site, std::forward<decltype( x )>( x ), holds );
+                }
+            } );
+        }
+    }
+
+
+    //*** debugGatedPrinterV(), debugGatedPrinterArr() and debugGatedMsg() variants
+
+    // Debugging version overloads
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedPrinterV( std::true_type, const Gate& gate, Deferred<Args> args )
+    {
+        if ( siteEnabled( Site ) && gatePasses<Site>( gate ) )
+        {
+            args.pass( []( auto&&... x ) { emitRecordV<decltype( x )...>( Site, std::forward<decltype( x )>( x )... ); } );
+        }
+    }
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedPrinterArr( std::true_type, const Gate& gate, Deferred<Args> args )
+    {
+        if ( siteEnabled( Site ) && gatePasses<Site>( gate ) )
+        {
+            args.pass( []( auto&&... x ) { emitRecordArr( Site, x... ); } );
+        }
+    }
+
+    template <const CallSite* Site, typename Gate, typename Args>
+    void debugGatedMsg( std::true_type, const Gate& gate, Deferred<Args> args )
+    {
+        if ( siteEnabled( Site ) && gatePasses<Site>( gate ) )
+        {
+            args.pass( []( auto&& output ) { emitMsg( Site, std::forward<decltype( output )>( output ) ); } );
+        }
+    }
+
+
+    //*** debugMsg() variants ***
+
+    // The emitter of the records of debugMsg(), out of line and cold like emitRecord()
+    template<typename T>
+    [[gnu::cold, gnu::noinline]] void emitMsg( const CallSite* site, T&& output )
+    {
+        toSink( std::cerr, site, [&]
+        {
+            if constexpr ( is_rehashable<std::remove_reference_t<T>> )
+                return hashValue( output );
+            else
+                return std::uint64_t{ 0 };
+        }, [&]( std::ostream& os )
+        {
+            os << site->filename << "(" << site->lineNbr << "): ";
+            if constexpr ( std::is_pointer_v<std::decay_t<T>> && std::is_convertible_v<T, const char*> )
+                print( os, static_cast<const char*>( output ) );
+            else
+                os << output;
+            os << std::endl;
+        } );
+    }
+
+    // Debugging version overload
+    template <typename Args>
+    void debugMsg( std::true_type, const CallSite* site, Deferred<Args> args )
+    {
+        if ( siteEnabled( site ) )
+        {
+            args.pass( [site]( auto&& output ) { emitMsg( site, std::forward<decltype( output )>( output ) ); } );
         }
     }
 
 
 }   // namespace DebugUtils
 
+#endif  // DEBUGUTILS_FULL_HEADER
+
+
+
+namespace DebugUtils
+{
+
+    // The log file is used if any log level is compiled in (Error is the highest level)
+    class DebugFileOn : public DebugFileOnBase<LevelPolicy<Error>>
+    {
+        public:
+            DebugFileOn( const char* filename ) : DebugFileOnBase( LevelPolicy<Error>{}, filename ) {}
+
+            template <typename Filename>
+            DebugFileOn( Deferred<Filename> filename ) : DebugFileOnBase( LevelPolicy<Error>{}, filename ) {}
+    };
 
-// Convenience macros to provide __FILE__, __LINE__ and the catenation of variable names
-#define debugV(...)         DebugUtils::debugPrinterV( __FILE__,  __LINE__, #__VA_ARGS__, __VA_ARGS__ )
-#define debugArr(...)       DebugUtils::debugPrinterArr( __FILE__,  __LINE__, #__VA_ARGS__, __VA_ARGS__ )
-#define debugM( msg )       DebugUtils::debugMsg( __FILE__,  __LINE__, msg )
+}   // namespace DebugUtils
 
-// Convenience macros for conditional debugging
-#define debugCondV( active, ...)    DebugUtils::debugPrinterV( active, __FILE__,  __LINE__, #__VA_ARGS__, __VA_ARGS__ )
-#define debugCondArr( active, ...)  DebugUtils::debugPrinterArr( active, __FILE__,  __LINE__, #__VA_ARGS__, __VA_ARGS__ )
-#define debugCondM( active, msg )   DebugUtils::debugMsg( active, __FILE__,  __LINE__, msg )
 
-// Convenience macro to instantiate a file to log all the debug output
-#define logDebugToFile( filename )      DebugUtils::DebugFileOn debugEnabled( filename )
+// The macros are in their own header so that they can be used with the DebugUtils module as well (see DebugUtils.cppm)
+#include "DebugUtilsMacros.hpp"
 
 #endif  // DebugUtils_h
+
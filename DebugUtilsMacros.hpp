@@ -0,0 +1,114 @@
+/*
+    DebugUtilsMacros.hpp
+
+    The macros of DebugUtils (see DebugUtils.hpp).  DebugUtils.hpp includes this header; translation units 
+    that import the DebugUtils module include it after the import, because modules don't export macros:
+
+        import DebugUtils;
+        #include "DebugUtilsMacros.hpp"
+
+    This version of the code is open source shared under an MIT license.
+
+    Copyright (c) 2025 Anshul Johri and Igor Mikolic-Torreira 
+
+    See DebugUtils.hpp for the full license text.
+*/
+
+
+
+#ifndef DebugUtilsMacros_hpp
+#define DebugUtilsMacros_hpp
+
+#include <source_location>
+
+
+
+// Declares the static constexpr descriptor of a call site, std::source_location supplies the file, line and function,
+// its runtime switch and debugUtilsPolicy, the call site's policy.  The descriptor is registered if the policy is on.
+// The macros below wrap it in a block with the call, so each call site has its own descriptor.
+#define DEBUGUTILS_CALLSITE( policy, ... )  using debugUtilsPolicy = policy; \
+                                            constinit static DebugUtils::SiteFlag debugUtilsSiteFlag{}; \
+                                            static constexpr DebugUtils::CallSite debugUtilsCallSite{ std::source_location::current(), &debugUtilsSiteFlag, __VA_ARGS__ }; \
+                                            DebugUtils::registerCallSite<&debugUtilsCallSite>( policy{} )
+
+// Wraps the arguments of a debugging call in a lambda, so that they are only evaluated if a record is emitted 
+// (see DebugUtils::Deferred).  The names of the arguments are still those in the macro call.  The calls are in an
+// if constexpr on the policy:  when it is off, the lambda isn't created either, so the variables it would capture
+// by reference aren't taken the address of, and the code is the same as without the call.
+#define DEBUGUTILS_DEFER( ... )             DebugUtils::Deferred{ [&]( auto&& debugUtilsEmit ) { debugUtilsEmit( __VA_ARGS__ ); } }
+
+// Convenience macros to provide the call site descriptor and the catenation of variable names
+#define debugV(...)         do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterV( &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugArr(...)       do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterArr( &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugM( msg )       do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #msg ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugMsg( &debugUtilsCallSite, DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macros for debugging at a log level (Trace, Debug, Info, Warn or Error)
+#define debugLevelV( level, ...)    do { DEBUGUTILS_CALLSITE( DebugUtils::LevelPolicy<DebugUtils::level>, #__VA_ARGS__, DebugUtils::level::value ); \
+                                        if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterV( DebugUtils::level{}, &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugLevelArr( level, ...)  do { DEBUGUTILS_CALLSITE( DebugUtils::LevelPolicy<DebugUtils::level>, #__VA_ARGS__, DebugUtils::level::value ); \
+                                        if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterArr( DebugUtils::level{}, &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugLevelM( level, msg )   do { DEBUGUTILS_CALLSITE( DebugUtils::LevelPolicy<DebugUtils::level>, #msg, DebugUtils::level::value ); \
+                                        if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugMsg( DebugUtils::level{}, &debugUtilsCallSite, DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macros for debugging in a category (any type, see debugCategoryPolicy())
+#define debugCatV( category, ...)   do { DEBUGUTILS_CALLSITE( DebugUtils::CategoryPolicy<category>, #__VA_ARGS__, DebugUtils::Debug::value, #category ); \
+                                        if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterV( DebugUtils::InCategory<category>{}, &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugCatArr( category, ...) do { DEBUGUTILS_CALLSITE( DebugUtils::CategoryPolicy<category>, #__VA_ARGS__, DebugUtils::Debug::value, #category ); \
+                                        if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterArr( DebugUtils::InCategory<category>{}, &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugCatM( category, msg )  do { DEBUGUTILS_CALLSITE( DebugUtils::CategoryPolicy<category>, #msg, DebugUtils::Debug::value, #category ); \
+                                        if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugMsg( DebugUtils::InCategory<category>{}, &debugUtilsCallSite, DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macro for diff mode (the call site descriptor also identifies the call site's state)
+#define debugDiffV(...)     do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugDiffPrinterV<&debugUtilsCallSite>( DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+
+// Convenience macro for dedup mode (records identical to the call site's previous record are only counted)
+#define debugDedupV(...)    do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugDedupPrinterV<&debugUtilsCallSite>( DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+
+// Convenience macros for watchpoints, a record only when the variable changes or when predicate( var ) flips (the
+// predicate is anything callable with the variable, e.g., a lambda)
+#define debugOnChange( var )                    do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #var ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugOnChangePrinterV<&debugUtilsCallSite>( DEBUGUTILS_DEFER( var ) ); } while ( false )
+#define debugWatch( var, predicate )            do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #var ", " #predicate ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugWatchPrinterV<&debugUtilsCallSite>( DEBUGUTILS_DEFER( var, predicate ) ); } while ( false )
+
+// Convenience macros for rate limited debugging (at most perSecond records per second, in bursts of up to burst records)
+#define debugRateV( perSecond, burst, ...)      do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterV<&debugUtilsCallSite>( DebugUtils::RateLimit( perSecond, burst ), DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugRateArr( perSecond, burst, ...)    do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterArr<&debugUtilsCallSite>( DebugUtils::RateLimit( perSecond, burst ), DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugRateM( perSecond, burst, msg )     do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #msg ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedMsg<&debugUtilsCallSite>( DebugUtils::RateLimit( perSecond, burst ), DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macros for sampled debugging, the first n hits of the call site
+#define debugFirstNV( n, ...)                   do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterV<&debugUtilsCallSite>( DebugUtils::FirstN( n ), DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugFirstNArr( n, ...)                 do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterArr<&debugUtilsCallSite>( DebugUtils::FirstN( n ), DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugFirstNM( n, msg )                  do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #msg ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedMsg<&debugUtilsCallSite>( DebugUtils::FirstN( n ), DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macros for sampled debugging, every nth hit of the call site, starting with the first
+#define debugEveryNV( n, ...)                   do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterV<&debugUtilsCallSite>( DebugUtils::EveryN( n ), DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugEveryNArr( n, ...)                 do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterArr<&debugUtilsCallSite>( DebugUtils::EveryN( n ), DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugEveryNM( n, msg )                  do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #msg ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedMsg<&debugUtilsCallSite>( DebugUtils::EveryN( n ), DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macros for sampled debugging, the first hit and then at most one hit per interval, a std::chrono::duration
+#define debugEveryTV( interval, ...)            do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterV<&debugUtilsCallSite>( DebugUtils::EveryT{ interval }, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugEveryTArr( interval, ...)          do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedPrinterArr<&debugUtilsCallSite>( DebugUtils::EveryT{ interval }, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugEveryTM( interval, msg )           do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #msg ); \
+                                                    if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugGatedMsg<&debugUtilsCallSite>( DebugUtils::EveryT{ interval }, DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macros for conditional debugging
+#define debugCondV( active, ...)    do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterV( active, &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugCondArr( active, ...)  do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #__VA_ARGS__ ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugPrinterArr( active, &debugUtilsCallSite, DEBUGUTILS_DEFER( __VA_ARGS__ ) ); } while ( false )
+#define debugCondM( active, msg )   do { DEBUGUTILS_CALLSITE( DebugUtils::DebugUtilsPolicy, #msg ); if constexpr ( debugUtilsPolicy::value ) DebugUtils::debugMsg( active, &debugUtilsCallSite, DEBUGUTILS_DEFER( msg ) ); } while ( false )
+
+// Convenience macro to instantiate a file to log all the debug output (the file name is deferred too)
+#define logDebugToFile( filename )      DebugUtils::DebugFileOn debugEnabled( DEBUGUTILS_DEFER( filename ) )
+
+#endif  // DebugUtilsMacros_hpp
@@ -0,0 +1,146 @@
+# BenchCompileTime.cmake
+#
+# Measures what including DebugUtils.hpp costs the compiler.  A translation unit with NBR_CALLS debugV() calls
+# (spread over functions of 100 calls, with int, double, std::string and std::vector<int> arguments) is 
+# generated and compiled three ways:
+#
+#   NONE  the same translation unit without DebugUtils.hpp and without the debugging calls
+#   OFF   DEBUGUTILS_ON=0
+#   ON    DEBUGUTILS_ON=1
+#
+# The compile time and peak compiler memory of each are reported (measured by MeasureCommand).  A fourth
+# translation unit, with only the #include and nothing else, shows the fixed cost of the header itself.
+#
+# When MODULE_FLAGS is given (the compiler flags that enable modules), a project of NBR_FILES translation 
+# units with 20 debugV() calls each is also generated and compiled twice, once including DebugUtils.hpp and 
+# once importing the DebugUtils module (compiled once, DebugUtils.cppm).  The total compile time (including 
+# compiling the module) and the peak compiler memory are reported for OFF and ON.  The project's translation 
+# units use no standard headers (GCC 12 can't include them alongside the import).
+#
+# Run as:
+#   cmake -DCXX=<compiler> -DMEASURE=<MeasureCommand> -DFLAGS="<flags>" -DINCLUDE_DIR=<dir> -DWORK_DIR=<dir>
+#         [-DNBR_CALLS=<number of debugV calls>] [-DMODULE_FLAGS="<flags>" [-DNBR_FILES=<number of files>]] 
+#         -P BenchCompileTime.cmake
+
+cmake_minimum_required( VERSION 3.14 )
+
+separate_arguments( flags UNIX_COMMAND "${FLAGS}" )
+if ( NOT NBR_CALLS )
+    set( NBR_CALLS 2000 )
+endif()
+file( MAKE_DIRECTORY "${WORK_DIR}" )
+
+set( args "i" "d" "s" "v" "i, d" "s, v" "i, s, v" "d, v" )
+list( LENGTH args nbrArgs )
+
+set( body "" )
+math( EXPR lastCall "${NBR_CALLS} - 1" )
+foreach( k RANGE ${lastCall} )
+    math( EXPR inFunction "${k} % 100" )
+    if ( inFunction EQUAL 0 )
+        if ( k GREATER 0 )
+            string( APPEND body "}\n\n" )
+        endif()
+        string( APPEND body "void f${k}( int i, double d, const std::string& s, const std::vector<int>& v )\n{\n" )
+    endif()
+    math( EXPR choice "${k} % ${nbrArgs}" )
+    list( GET args ${choice} arg )
+    string( APPEND body "    debugV( ${arg} );\n" )
+endforeach()
+string( APPEND body "}\n" )
+
+set( prologue "// Generated by BenchCompileTime.cmake\n\n#include <string>\n#include <vector>\n\n" )
+file( WRITE "${WORK_DIR}/none.cpp" "${prologue}#define debugV( ... )\n\n${body}" )
+file( WRITE "${WORK_DIR}/calls.cpp" "${prologue}#include \"DebugUtils.hpp\"\n\n${body}" )
+file( WRITE "${WORK_DIR}/header.cpp" "// Generated by BenchCompileTime.cmake\n\n#include \"DebugUtils.hpp\"\n" )
+
+# Compiles a source (with extra compiler arguments), sets ms and kb in the caller to its compile time and peak memory
+function( compile source arguments )
+    execute_process( 
+        COMMAND "${MEASURE}" "${CXX}" ${flags} ${arguments} "-I${INCLUDE_DIR}" -c "${source}"
+        WORKING_DIRECTORY "${WORK_DIR}"
+        RESULT_VARIABLE rc 
+        OUTPUT_VARIABLE measured
+        ERROR_VARIABLE err )
+    if ( NOT rc EQUAL 0 )
+        message( FATAL_ERROR "Failed to compile ${source}:\n${err}" )
+    endif()
+    separate_arguments( measured UNIX_COMMAND "${measured}" )
+    list( GET measured 0 elapsed )
+    list( GET measured 1 peak )
+    set( ms ${elapsed} PARENT_SCOPE )
+    set( kb ${peak} PARENT_SCOPE )
+endfunction()
+
+function( measure label source defines )
+    compile( "${WORK_DIR}/${source}" "${defines}" )
+    math( EXPR mb "${kb} / 1024" )
+    message( STATUS "${label}: ${ms} ms, peak ${mb} MB" )
+endfunction()
+
+message( STATUS "${NBR_CALLS} debugV() calls" )
+measure( "NONE" none.cpp "" )
+measure( "OFF" calls.cpp "-DDEBUGUTILS_ON=0" )
+measure( "ON" calls.cpp "-DDEBUGUTILS_ON=1" )
+measure( "Header only, OFF" header.cpp "-DDEBUGUTILS_ON=0" )
+measure( "Header only, ON" header.cpp "-DDEBUGUTILS_ON=1" )
+
+
+if ( NOT MODULE_FLAGS )
+    return()
+endif()
+
+separate_arguments( moduleFlags UNIX_COMMAND "${MODULE_FLAGS}" )
+if ( NOT NBR_FILES )
+    set( NBR_FILES 50 )
+endif()
+set( projectDir "${WORK_DIR}/project" )
+file( MAKE_DIRECTORY "${projectDir}" )
+file( WRITE "${projectDir}/DebugUtils.mapper" "DebugUtils ${projectDir}/DebugUtils.gcm\n" )
+list( APPEND moduleFlags "-fmodule-mapper=${projectDir}/DebugUtils.mapper" )
+
+set( args "i" "d" "s" "i, d" "d, s" "i, d, s" )
+math( EXPR lastFile "${NBR_FILES} - 1" )
+foreach( k RANGE ${lastFile} )
+    set( body "void f${k}( int i, double d, const char* s )\n{\n" )
+    foreach( c RANGE 19 )
+        math( EXPR choice "( ${k} + ${c} ) % 6" )
+        list( GET args ${choice} arg )
+        string( APPEND body "    debugV( ${arg} );\n" )
+    endforeach()
+    string( APPEND body "}\n" )
+    file( WRITE "${projectDir}/header${k}.cpp" "// Generated by BenchCompileTime.cmake\n\n#include \"DebugUtils.hpp\"\n\n${body}" )
+    file( WRITE "${projectDir}/module${k}.cpp" 
+          "// Generated by BenchCompileTime.cmake\n\nimport DebugUtils;\n#include \"DebugUtilsMacros.hpp\"\n\n${body}" )
+endforeach()
+
+message( STATUS "Project of ${NBR_FILES} files with 20 debugV() calls each" )
+set( WORK_DIR "${projectDir}" )
+foreach( onValue 0 1 )
+    foreach( variant header module )
+        set( totalMs 0 )
+        set( peakKb 0 )
+        if ( variant STREQUAL "module" )
+            compile( "${INCLUDE_DIR}/DebugUtils.cppm" "-DDEBUGUTILS_ON=${onValue};${moduleFlags};-xc++" )
+            set( totalMs ${ms} )
+            set( peakKb ${kb} )
+            set( arguments "${moduleFlags}" )
+        else()
+            set( arguments "-DDEBUGUTILS_ON=${onValue}" )
+        endif()
+        foreach( k RANGE ${lastFile} )
+            compile( "${projectDir}/${variant}${k}.cpp" "${arguments}" )
+            math( EXPR totalMs "${totalMs} + ${ms}" )
+            if ( kb GREATER peakKb )
+                set( peakKb ${kb} )
+            endif()
+        endforeach()
+        math( EXPR mb "${peakKb} / 1024" )
+        if ( onValue )
+            set( mode "ON" )
+        else()
+            set( mode "OFF" )
+        endif()
+        message( STATUS "${mode}, ${variant}: ${totalMs} ms in total, peak ${mb} MB" )
+    endforeach()
+endforeach()
@@ -0,0 +1,131 @@
+// Microbenchmark of a disabled debugCondV() in a hot loop.  The same loop (a scalar hash chain over a 
+// vector, which the compiler can't vectorize) is timed three ways:
+//
+//   bare       without debugging
+//   cond       with debugCondV( x[i] < 0, i, h, tag ), whose condition is never true
+//   inline     with the record built inline under the same condition (how debugPrinterV() worked before
+//              its emission code moved out of line), for comparison
+//
+// Each loop is timed several times and the fastest run is kept.  The cost of the disabled debugCondV() is the 
+// difference between cond and bare, and the program fails if it is one cycle per iteration or more.  Cycles 
+// are counted with the time stamp counter (x86-64 only), elsewhere only nanoseconds are reported.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined( __x86_64__ )
+    #include <x86intrin.h>
+#endif
+
+#define DEBUGUTILS_ON 1
+#include "DebugUtils.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t nbrElements{ 1 << 16 };
+    constexpr int nbrRuns{ 200 };
+
+    struct Timing
+    {
+        double  ns;
+        double  cycles;
+    };
+
+    std::uint64_t cycleCount()
+    {
+#if defined( __x86_64__ )
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+
+    [[gnu::noinline]] unsigned bare( const std::vector<int>& x, const std::string& )
+    {
+        unsigned h{ 0 };
+        for ( std::size_t i = 0; i < x.size(); i++ )
+        {
+            h = h * 31 + x[i];
+        }
+        return h;
+    }
+
+    [[gnu::noinline]] unsigned cond( const std::vector<int>& x, const std::string& tag )
+    {
+        unsigned h{ 0 };
+        for ( std::size_t i = 0; i < x.size(); i++ )
+        {
+            h = h * 31 + x[i];
+            debugCondV( x[i] < 0, i, h, tag );
+        }
+        return h;
+    }
+
+    [[gnu::noinline]] unsigned inlined( const std::vector<int>& x, const std::string& tag )
+    {
+        static constexpr DebugUtils::CallSite site{ std::source_location::current(), nullptr, "i, h, tag" };
+        unsigned h{ 0 };
+        for ( std::size_t i = 0; i < x.size(); i++ )
+        {
+            h = h * 31 + x[i];
+            if ( x[i] < 0 )
+            {
+                const DebugUtils::ArgRef args[]{ DebugUtils::argRef( i ), DebugUtils::argRef( h ), DebugUtils::argRef( tag ) };
+                DebugUtils::emitRecord( std::cerr, &site, args, 3 );
+            }
+        }
+        return h;
+    }
+
+
+    // Fastest of nbrRuns runs, per iteration
+    Timing time( unsigned (*loop)( const std::vector<int>&, const std::string& ), const std::vector<int>& x, const std::string& tag )
+    {
+        Timing best{ 1e300, 1e300 };
+        volatile unsigned sink{ 0 };
+        for ( int run = 0; run < nbrRuns; run++ )
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto startCycles = cycleCount();
+            sink = sink + loop( x, tag );
+            auto cycles = cycleCount() - startCycles;
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best.ns = std::min( best.ns, elapsed.count() / x.size() );
+            best.cycles = std::min( best.cycles, static_cast<double>( cycles ) / x.size() );
+        }
+        return best;
+    }
+}
+
+
+
+int main()
+{
+    std::vector<int> x( nbrElements );
+    for ( std::size_t i = 0; i < x.size(); i++ )
+    {
+        x[i] = static_cast<int>( ( i * 2654435761u ) % 1000 );
+    }
+    std::string tag{ "tag" };
+
+    Timing b = time( bare, x, tag );
+    Timing c = time( cond, x, tag );
+    Timing in = time( inlined, x, tag );
+
+    std::printf( "bare:    %6.3f ns  %6.3f cycles per iteration\n", b.ns, b.cycles );
+    std::printf( "cond:    %6.3f ns  %6.3f cycles per iteration\n", c.ns, c.cycles );
+    std::printf( "inline:  %6.3f ns  %6.3f cycles per iteration\n", in.ns, in.cycles );
+    std::printf( "disabled debugCondV() costs %.3f ns, %.3f cycles per iteration\n", c.ns - b.ns, c.cycles - b.cycles );
+
+    if ( c.cycles - b.cycles >= 1.0 )
+    {
+        std::printf( "FAILED: a disabled debugCondV() costs one cycle per iteration or more\n" );
+        return 1;
+    }
+}
@@ -0,0 +1,109 @@
+# BenchTypeErasure.cmake
+#
+# Measures what the type erased emitter behind debugPrinterV() saves in ON builds.  A source with one call 
+# site for each ordered choice of three out of eight argument types (336 distinct argument lists) is 
+# generated in two variants:
+#
+#   RECURSIVE  each call site formats its record with printerV() (see RecursivePrinter.hpp), one template 
+#              recursion per argument list
+#   ERASED     each call site uses debugV(), an array of (pointer, formatter) pairs and one shared emitter
+#
+# Both are compiled with DEBUGUTILS_ON=1 and the compile time and .text size are reported.  Each executable
+# then calls all the call sites in a loop, with std::cerr writing to a null buffer, and reports the time per
+# record.  The loop runs through the code of every call site, so its time reflects instruction cache pressure.
+#
+# Run as:
+#   cmake -DCXX=<compiler> -DOBJCOPY=<objcopy> -DFLAGS="<flags>" -DINCLUDE_DIR=<dir> -DWORK_DIR=<dir> 
+#         [-DREPS=<loop count>] -P BenchTypeErasure.cmake
+
+cmake_minimum_required( VERSION 3.23 )
+
+separate_arguments( flags UNIX_COMMAND "${FLAGS}" )
+if ( NOT REPS )
+    set( REPS 200 )
+endif()
+file( MAKE_DIRECTORY "${WORK_DIR}" )
+
+set( names i l d c b s v p )
+set( calls "" )
+set( nbrSites 0 )
+foreach( a IN LISTS names )
+    foreach( b IN LISTS names )
+        foreach( c IN LISTS names )
+            if ( NOT a STREQUAL b AND NOT a STREQUAL c AND NOT b STREQUAL c )
+                string( APPEND calls "    BENCH_RECORD( ${a}, ${b}, ${c} );\n" )
+                math( EXPR nbrSites "${nbrSites} + 1" )
+            endif()
+        endforeach()
+    endforeach()
+endforeach()
+
+set( recursiveRecord 
+"#define BENCH_RECORD( ... )  do { static constexpr DebugUtils::CallSite site{ std::source_location::current(), nullptr, #__VA_ARGS__ }; \\
+                                  std::cerr << site.filename << \"(\" << site.lineNbr << \") [ \", BenchTypeErasure::printerV( std::cerr, site.names, __VA_ARGS__ ); } while ( false )" )
+set( erasedRecord "#define BENCH_RECORD( ... )  debugV( __VA_ARGS__ )" )
+
+set( recursiveInclude "#include \"${CMAKE_CURRENT_LIST_DIR}/RecursivePrinter.hpp\"" )
+set( erasedInclude "" )
+
+foreach( variant recursive erased )
+    file( WRITE "${WORK_DIR}/${variant}.cpp"
+"// Generated by BenchTypeErasure.cmake
+
+#include <chrono>
+#include \"DebugUtils.hpp\"
+${${variant}Include}
+
+${${variant}Record}
+
+namespace
+{
+    struct NullBuffer : std::streambuf
+    {
+        int overflow( int c ) override { return c; }
+        std::streamsize xsputn( const char*, std::streamsize n ) override { return n; }
+    };
+}
+
+[[gnu::noinline]] void records( int i, long l, double d, char c, bool b, const std::string& s, const std::vector<int>& v, const std::pair<int, double>& p )
+{
+${calls}}
+
+int main()
+{
+    NullBuffer null;
+    auto original = std::cerr.rdbuf( &null );
+    std::string s{ \"string\" };
+    std::vector<int> v{ 1, 2, 3, 4, 5 };
+    std::pair<int, double> p{ 1, 2.5 };
+
+    auto start = std::chrono::steady_clock::now();
+    for ( int r = 0; r < ${REPS}; r++ )
+    {
+        records( r, 2L * r, 0.5 * r, 'x', r & 1, s, v, p );
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cerr.rdbuf( original );
+    std::cout << elapsed.count() / ( ${REPS} * ${nbrSites} ) << std::endl;
+}
+" )
+
+    string( TIMESTAMP start "%s%f" UTC )
+    execute_process( 
+        COMMAND "${CXX}" ${flags} -DDEBUGUTILS_ON=1 "-I${INCLUDE_DIR}" "${WORK_DIR}/${variant}.cpp" -o "${WORK_DIR}/${variant}"
+        RESULT_VARIABLE rc 
+        ERROR_VARIABLE err )
+    string( TIMESTAMP stop "%s%f" UTC )
+    if ( NOT rc EQUAL 0 )
+        message( FATAL_ERROR "Failed to compile ${variant}.cpp:\n${err}" )
+    endif()
+    math( EXPR compileMs "( ${stop} - ${start} ) / 1000" )
+
+    execute_process( COMMAND "${OBJCOPY}" -O binary --only-section=.text "${WORK_DIR}/${variant}" "${WORK_DIR}/${variant}.text" )
+    file( SIZE "${WORK_DIR}/${variant}.text" textSize )
+
+    execute_process( COMMAND "${WORK_DIR}/${variant}" OUTPUT_VARIABLE nsPerRecord OUTPUT_STRIP_TRAILING_WHITESPACE )
+
+    message( STATUS "${variant}: ${nbrSites} call sites, compile ${compileMs} ms, .text ${textSize} bytes, ${nsPerRecord} ns per record" )
+endforeach()
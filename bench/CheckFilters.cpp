@@ -0,0 +1,166 @@
+// Executed checks of the filter specs documented in README.md (Filters) and of the glob matching of file names.
+// Each check applies a spec with DebugUtils::applyFilter() and compares the call sites of this file that are
+// switched on with the expected ones.  The call sites are told apart by their argument names.  The program
+// fails if any check fails.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define DEBUGUTILS_ON 1
+#include "DebugUtils.hpp"
+
+
+
+namespace Parser
+{
+    void parse( int parseArg )
+    {
+        debugV( parseArg );
+        debugLevelV( Warn, parseArg );
+    }
+}
+
+namespace
+{
+    void other( int otherArg )
+    {
+        debugV( otherArg );
+        debugLevelV( Error, otherArg );
+        debugLevelV( Trace, otherArg );
+    }
+
+    int nbrFailures{ 0 };
+
+    // The call sites of this file, as "<argument names>@<level>", that are on
+    std::vector<std::string> sitesOn()
+    {
+        std::vector<std::string> on;
+        for ( auto site : DebugUtils::callSites() )
+        {
+            if ( DebugUtils::matchesFile( "CheckFilters.cpp", site->path ) && DebugUtils::siteEnabled( site ) )
+            {
+                on.push_back( std::string{ site->names } + "@" + std::to_string( site->level ) );
+            }
+        }
+        std::sort( on.begin(), on.end() );
+        return on;
+    }
+
+    // The line of the call site of this file with these argument names and level
+    int lineOf( const char* names, int level )
+    {
+        for ( auto site : DebugUtils::callSites() )
+        {
+            if ( DebugUtils::matchesFile( "CheckFilters.cpp", site->path ) && std::string{ site->names } == names && site->level == level )
+            {
+                return site->lineNbr;
+            }
+        }
+        return 0;
+    }
+
+    void checkSpec( const std::string& spec, bool valid, std::vector<std::string> expected )
+    {
+        bool parsed = DebugUtils::applyFilter( spec.c_str() );
+        auto on = sitesOn();
+        std::sort( expected.begin(), expected.end() );
+        if ( parsed != valid || on != expected )
+        {
+            std::printf( "FAILED: \"%s\" is %s and switches on", spec.c_str(), parsed ? "valid" : "invalid" );
+            for ( auto& s : on )
+            {
+                std::printf( " %s", s.c_str() );
+            }
+            std::printf( "\n" );
+            nbrFailures++;
+        }
+    }
+
+    void checkGlob( const char* pattern, const char* path, bool expected )
+    {
+        if ( DebugUtils::matchesFile( pattern, path ) != expected )
+        {
+            std::printf( "FAILED: \"%s\" %s \"%s\"\n", pattern, expected ? "doesn't match" : "matches", path );
+            nbrFailures++;
+        }
+    }
+}
+
+
+
+int main()
+{
+    Parser::parse( 1 );
+    other( 2 );
+
+    const std::string trace{ std::to_string( DebugUtils::Trace::value ) };
+    const std::string debug{ std::to_string( DebugUtils::Debug::value ) };
+    const std::string warn{ std::to_string( DebugUtils::Warn::value ) };
+    const std::string error{ std::to_string( DebugUtils::Error::value ) };
+    const std::vector<std::string> all{ "parseArg@" + debug, "parseArg@" + warn, "otherArg@" + debug, "otherArg@" + error, "otherArg@" + trace };
+
+    // Files, as globs
+    checkSpec( "CheckFilters.cpp", true, all );
+    checkSpec( "bench/*.cpp", true, all );
+    checkSpec( "Check?ilters.cpp", true, all );
+    checkSpec( "*.hpp", true, {} );
+    checkSpec( "-CheckFilters.cpp", true, {} );
+
+    // Levels
+    checkSpec( "CheckFilters.cpp:warn", true, { "parseArg@" + warn, "otherArg@" + error } );
+    checkSpec( "level=error", true, { "otherArg@" + error } );
+    checkSpec( "-level=debug", true, { "otherArg@" + trace } );
+    checkSpec( "level = error", true, { "otherArg@" + error } );
+    checkSpec( " - level =debug ", true, { "otherArg@" + trace } );
+
+    // Line ranges
+    std::string parseLine{ std::to_string( lineOf( "parseArg", DebugUtils::Debug::value ) ) };
+    std::string warnLine{ std::to_string( lineOf( "parseArg", DebugUtils::Warn::value ) ) };
+    std::string otherLine{ std::to_string( lineOf( "otherArg", DebugUtils::Debug::value ) ) };
+    checkSpec( "CheckFilters.cpp:" + parseLine, true, { "parseArg@" + debug } );
+    checkSpec( "CheckFilters.cpp:" + parseLine + "-" + warnLine, true, { "parseArg@" + debug, "parseArg@" + warn } );
+    checkSpec( "CheckFilters.cpp:" + warnLine + "-" + otherLine, true, { "parseArg@" + warn, "otherArg@" + debug } );
+    checkSpec( " CheckFilters.cpp : " + parseLine + " ", true, { "parseArg@" + debug } );
+
+    // Functions
+    checkSpec( "fn=Parser::parse", true, { "parseArg@" + debug, "parseArg@" + warn } );
+    checkSpec( "-fn=Parser::parse", true, { "otherArg@" + debug, "otherArg@" + error, "otherArg@" + trace } );
+    checkSpec( "fn = Parser::parse", true, { "parseArg@" + debug, "parseArg@" + warn } );
+    checkSpec( "fn= Parser::parse : warn", true, { "parseArg@" + warn } );
+
+    // Sinks and backtraces select no call sites
+    checkSpec( "sink = stderr", true, all );
+    checkSpec( "backtrace = 0, fn=other", true, { "otherArg@" + debug, "otherArg@" + error, "otherArg@" + trace } );
+
+    // Several terms, comments and newlines:  the last term that selects a call site decides
+    checkSpec( "CheckFilters.cpp, -fn=Parser::parse", true, { "otherArg@" + debug, "otherArg@" + error, "otherArg@" + trace } );
+    checkSpec( "fn=other  # Comment\n-level=warn", true, { "otherArg@" + debug, "otherArg@" + trace } );
+
+    // Terms that can't be parsed are ignored
+    checkSpec( "CheckFilters.cpp:12x", false, all );
+    checkSpec( "CheckFilters.cpp : x12, fn=Parser::parse", false, { "parseArg@" + debug, "parseArg@" + warn } );
+    checkSpec( "level=loud", false, all );
+    checkSpec( "lvl=warn", false, all );
+    checkSpec( "-sink=stderr", false, all );
+    checkSpec( "fn = ", false, all );
+
+    // Globs:  '*' and '?' don't match '/', and the pattern matches the whole path or an end of it after a '/'
+    checkGlob( "*.cpp", "a.cpp", true );
+    checkGlob( "*.cpp", "net/a.cpp", true );
+    checkGlob( "net/*.cpp", "src/net/a.cpp", true );
+    checkGlob( "net/*.cpp", "src/net/sub/a.cpp", false );
+    checkGlob( "net*.cpp", "net/a.cpp", false );
+    checkGlob( "?.cpp", "a.cpp", true );
+    checkGlob( "?.cpp", "ab.cpp", false );
+    checkGlob( "a?b.cpp", "a/b.cpp", false );
+    checkGlob( "t.cpp", "net/at.cpp", false );
+    checkGlob( "*", "net/a.cpp", true );
+    checkGlob( "**.cpp", "a.cpp", true );
+    checkGlob( "a*", "a", true );
+    checkGlob( "", "a.cpp", false );
+
+    std::printf( "%s\n", nbrFailures ? "Some filter checks failed" : "All filter checks passed" );
+    return nbrFailures ? 1 : 0;
+}
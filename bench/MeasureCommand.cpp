@@ -0,0 +1,47 @@
+// Runs a command and reports its wall clock time and peak memory (the largest resident set size of the
+// command and all of its descendants, e.g., cc1plus under g++) as "<milliseconds> <kilobytes>" on stdout.
+// The command's own exit status is returned.  Linux (and other POSIX systems with wait4 semantics) only.
+//
+// Usage:  MeasureCommand <command> [<arguments>...]
+
+#include <chrono>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <command> [<arguments>...]" << std::endl;
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if ( pid == 0 )
+    {
+        execvp( argv[1], argv + 1 );
+        _exit( 127 );
+    }
+    if ( pid < 0 )
+    {
+        std::cerr << "Unable to start " << argv[1] << std::endl;
+        return 2;
+    }
+
+    int status{ 0 };
+    waitpid( pid, &status, 0 );
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    // The children's usage includes every descendant that was waited for, ru_maxrss is the largest of them
+    rusage usage{};
+    getrusage( RUSAGE_CHILDREN, &usage );
+
+    std::cout << static_cast<long>( elapsed.count() ) << " " << usage.ru_maxrss << std::endl;
+    return WIFEXITED( status ) ? WEXITSTATUS( status ) : 1;
+}
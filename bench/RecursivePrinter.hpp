@@ -0,0 +1,37 @@
+// RecursivePrinter.hpp
+//
+// The emitter debugPrinterV() used before its arguments were type erased, kept as the baseline of 
+// bench_type_erasure (see BenchTypeErasure.cmake).  Every distinct argument list instantiates its own chain 
+// of printerV() calls.  It is included after DebugUtils.hpp, with DEBUGUTILS_ON=1.
+
+#ifndef RecursivePrinter_hpp
+#define RecursivePrinter_hpp
+
+
+
+namespace BenchTypeErasure
+{
+
+    // This is the variadic function that drives the template recursion
+    // Single arguments are passed to one of the print() functions
+    // The "tail" argument(s) is/are passed back to the printer() 
+    // function (but with one less argument to trigger the template recursion)
+    template <typename T, typename... V>
+    void printerV( std::ostream& os, const char* names, T&& head, V&&... tail )
+    {
+        int i = DebugUtils::nameLength( names );
+        os.write( names, i ) << " = ";
+        DebugUtils::print( os, std::forward<T>( head ) );
+        if constexpr ( sizeof...(tail) )
+        {
+            os << " ||", printerV( os, names + i + 1, std::forward<V>( tail )... );
+        }
+        else
+        {    
+            os << " ]\n";
+        }
+    }
+
+}   // namespace BenchTypeErasure
+
+#endif  // RecursivePrinter_hpp
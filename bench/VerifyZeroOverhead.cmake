@@ -0,0 +1,193 @@
+# VerifyZeroOverhead.cmake
+#
+# Verifies the DebugUtils zero overhead guarantee:  each source is built three ways,
+#
+#   ON        DEBUGUTILS_ON=1
+#   OFF       DEBUGUTILS_ON=0
+#   STRIPPED  DEBUGUTILS_ON=0 with the debugging calls removed by hand (well, by regular expression)
+#
+# and the .text section of the OFF executable must be byte-identical to that of the STRIPPED executable.
+# Arguments with side effects in the sources (e.g., calls to functions that print) check that OFF mode never
+# evaluates the arguments of the debugging calls.
+# The .text sizes of all three are reported.  
+#
+# GCC occasionally swaps the operands of a register to register cmp (e.g., cmp %rax,%rbp vs cmp %rbp,%rax)
+# because an inlined empty call renumbered its SSA temporaries.  This happens with the original DebugUtils
+# header too.  The functions where it is known to happen are listed in cmpSwapAllowed below, as 
+# <source name>:<function name>.  In these functions only, a cmp followed by je or jne (which doesn't 
+# depend on the order of the operands) is compared with its operands in a canonical order, and OFF code 
+# that only differs there passes, reported as "equivalent".  Any other difference is a mismatch:  the 
+# disassembly of the OFF and STRIPPED executables is written to the work directory and the script fails.
+#
+# OFF mode must not add static initializers either:  if the STRIPPED executable doesn't reference 
+# std::ios_base::Init or, since GCC 13, std::ios_base_library_init() (the iostreams initializer), the OFF 
+# executable must not reference it.
+#
+# Stripping removes every line that starts with a debugging macro (debugXxx(...), logDebugToFile(...)), 
+# declares a DebugUtils::DebugFileOn, or includes DebugUtils.hpp.  So each debugging call in the
+# sources must fit on a single line.
+#
+# Run as:
+#   cmake -DCXX=<compiler> -DOBJCOPY=<objcopy> -DOBJDUMP=<objdump> -DNM=<nm> -DFLAGS="<flags>" -DINCLUDE_DIR=<dir>
+#         -DWORK_DIR=<dir> -DSOURCES="<source1>|<source2>|..." -P VerifyZeroOverhead.cmake
+
+cmake_minimum_required( VERSION 3.14 )
+
+separate_arguments( flags UNIX_COMMAND "${FLAGS}" )
+string( REPLACE "|" ";" sources "${SOURCES}" )
+file( MAKE_DIRECTORY "${WORK_DIR}" )
+
+set( failures "" )
+
+set( cmpSwapAllowed
+    "StressNoStreams:main"
+    "StressTemplates:accumulate"
+)
+
+function( build_variant source defines output )
+    get_filename_component( sourceDir "${source}" DIRECTORY )
+    execute_process( 
+        COMMAND "${CXX}" ${flags} ${defines} "-I${INCLUDE_DIR}" "-iquote${sourceDir}" "${source}" -o "${output}"
+        RESULT_VARIABLE rc 
+        ERROR_VARIABLE err )
+    if ( NOT rc EQUAL 0 )
+        message( FATAL_ERROR "Failed to compile ${source}:\n${err}" )
+    endif()
+    execute_process( COMMAND "${OBJCOPY}" -O binary --only-section=.text "${output}" "${output}.text" RESULT_VARIABLE rc )
+    if ( NOT rc EQUAL 0 )
+        message( FATAL_ERROR "Failed to extract the .text section of ${output}" )
+    endif()
+endfunction()
+
+# Sets result to the disassembly of the executable with the operands of the cmp instructions allowed to swap 
+# (see cmpSwapAllowed) in a canonical order, and swapped to the list of the functions where there were any
+function( disassemble name executable result swapped )
+    execute_process( 
+        COMMAND "${OBJDUMP}" -d -C --no-show-raw-insn -j .text "${executable}" 
+        OUTPUT_FILE "${executable}.dis" )
+    file( READ "${executable}.dis" dis )
+    string( REGEX REPLACE "[^\n]*file format[^\n]*" "" dis "${dis}" )        # File name line
+    string( REPLACE ";" "<semicolon>" dis "${dis}" )                          # Keep the lines of the list whole
+    string( REPLACE "[" "<bracket>" dis "${dis}" )
+    string( REPLACE "]" "</bracket>" dis "${dis}" )
+    string( REPLACE "\n" ";" lines "${dis}" )
+
+    set( allowed FALSE )
+    set( pending "" )
+    set( out "" )
+    set( functions "" )
+    foreach( line IN LISTS lines )
+        if ( line MATCHES "^[0-9a-f]+ <(.*)>:$" )
+            set( current "${CMAKE_MATCH_1}" )
+            set( allowed FALSE )
+            foreach( entry IN LISTS cmpSwapAllowed )
+                if ( entry MATCHES "^${name}:(.*)$" )
+                    if ( current MATCHES "(^|[ :])${CMAKE_MATCH_1}([<(]|$)" )
+                        set( allowed TRUE )
+                    endif()
+                endif()
+            endforeach()
+        endif()
+        # The canonical order of a pending cmp only applies if the next instruction is je or jne
+        if ( pending AND line MATCHES ":\t(je|jne) " )
+            string( APPEND out "${pending}\n" )
+            if ( NOT pending STREQUAL pendingOriginal )
+                list( APPEND functions "${current}" )
+            endif()
+        elseif ( pending )
+            string( APPEND out "${pendingOriginal}\n" )
+        endif()
+        set( pending "" )
+        if ( allowed AND line MATCHES "^(.*:\tcmp[a-z]* +)(%[a-z0-9]+),(%[a-z0-9]+)$" )
+            set( pendingOriginal "${line}" )
+            if ( CMAKE_MATCH_2 STRGREATER CMAKE_MATCH_3 )
+                set( pending "${CMAKE_MATCH_1}${CMAKE_MATCH_3},${CMAKE_MATCH_2}" )
+            else()
+                set( pending "${line}" )
+            endif()
+        else()
+            string( APPEND out "${line}\n" )
+        endif()
+    endforeach()
+    if ( pending )
+        string( APPEND out "${pendingOriginal}\n" )
+    endif()
+    list( REMOVE_DUPLICATES functions )
+    set( ${result} "${out}" PARENT_SCOPE )
+    set( ${swapped} "${functions}" PARENT_SCOPE )
+endfunction()
+
+# Sets result to "yes" if the executable references std::ios_base::Init, "no" otherwise.  Since GCC 13, <iostream>
+# references std::ios_base_library_init() (_ZSt21ios_base_library_initv) instead of the constructor.
+function( uses_ios_init executable result )
+    execute_process( COMMAND "${NM}" -C "${executable}" OUTPUT_VARIABLE symbols RESULT_VARIABLE rc )
+    if ( NOT rc EQUAL 0 )
+        message( FATAL_ERROR "Failed to list the symbols of ${executable}" )
+    endif()
+    if ( symbols MATCHES "std::ios_base::Init::Init|std::ios_base_library_init|_ZSt21ios_base_library_initv" )
+        set( ${result} "yes" PARENT_SCOPE )
+    else()
+        set( ${result} "no" PARENT_SCOPE )
+    endif()
+endfunction()
+
+foreach( source IN LISTS sources )
+    get_filename_component( name "${source}" NAME_WE )
+
+    # The hand stripped variant
+    file( READ "${source}" text )
+    set( text "\n${text}" )
+    string( REGEX REPLACE "\n[ \t]*(debug[A-Za-z]*[ \t]*\\(|logDebugToFile[ \t]*\\(|DebugUtils::DebugFileOn[ \t]|DebugUtils::(enableSites|disableSites|applyFilter|applyFilterFile|enableBacktrace|flushBacktrace)[ \t]*\\()[^\n]*" "\n" text "${text}" )
+    string( REGEX REPLACE "\n#include[ \t]*\"DebugUtils.hpp\"[^\n]*" "\n" text "${text}" )
+    string( SUBSTRING "${text}" 1 -1 text )
+    get_filename_component( extension "${source}" EXT )
+    set( strippedSource "${WORK_DIR}/${name}_stripped${extension}" )
+    file( WRITE "${strippedSource}" "${text}" )
+
+    build_variant( "${source}" "-DDEBUGUTILS_ON=1" "${WORK_DIR}/${name}_on" )
+    build_variant( "${source}" "-DDEBUGUTILS_ON=0" "${WORK_DIR}/${name}_off" )
+    build_variant( "${strippedSource}" "-DDEBUGUTILS_ON=0" "${WORK_DIR}/${name}_stripped" )
+
+    file( SIZE "${WORK_DIR}/${name}_on.text" onSize )
+    file( SIZE "${WORK_DIR}/${name}_off.text" offSize )
+    file( SIZE "${WORK_DIR}/${name}_stripped.text" strippedSize )
+
+    execute_process( 
+        COMMAND "${CMAKE_COMMAND}" -E compare_files "${WORK_DIR}/${name}_off.text" "${WORK_DIR}/${name}_stripped.text" 
+        RESULT_VARIABLE different )
+    if ( NOT different )
+        set( verdict "identical" )
+    else()
+        disassemble( "${name}" "${WORK_DIR}/${name}_off" offDis offSwapped )
+        disassemble( "${name}" "${WORK_DIR}/${name}_stripped" strippedDis strippedSwapped )
+        if ( "${offDis}" STREQUAL "${strippedDis}" )
+            set( swapped ${offSwapped} ${strippedSwapped} )
+            list( REMOVE_DUPLICATES swapped )
+            list( JOIN swapped ", " swapped )
+            string( REPLACE "<bracket>" "[" swapped "${swapped}" )
+            string( REPLACE "</bracket>" "]" swapped "${swapped}" )
+            set( verdict "equivalent (cmp operands swapped in ${swapped})" )
+        else()
+            set( verdict "MISMATCH" )
+            list( APPEND failures "${name}" )
+        endif()
+    endif()
+
+    message( STATUS "${name}: .text ON ${onSize}, OFF ${offSize}, STRIPPED ${strippedSize} bytes -- OFF vs STRIPPED ${verdict}" )
+
+    uses_ios_init( "${WORK_DIR}/${name}_on" onIosInit )
+    uses_ios_init( "${WORK_DIR}/${name}_off" offIosInit )
+    uses_ios_init( "${WORK_DIR}/${name}_stripped" strippedIosInit )
+    if ( offIosInit STREQUAL "yes" AND strippedIosInit STREQUAL "no" )
+        set( verdict "MISMATCH" )
+        list( APPEND failures "${name} (std::ios_base::Init)" )
+    else()
+        set( verdict "OK" )
+    endif()
+    message( STATUS "${name}: std::ios_base::Init ON ${onIosInit}, OFF ${offIosInit}, STRIPPED ${strippedIosInit} -- ${verdict}" )
+endforeach()
+
+if ( failures )
+    message( FATAL_ERROR "OFF mode is not identical to the hand stripped code for: ${failures}\n"
+                         "See the .dis disassembly files in ${WORK_DIR}" )
+endif()
@@ -0,0 +1,67 @@
+// Stress translation unit for the zero overhead verification:  debugging calls on many kinds of 
+// containers and nested data structures.  Debugging calls must each fit on one line (see VerifyZeroOverhead.cmake).
+
+#include <array>
+#include <deque>
+#include <forward_list>
+#include <iostream>
+#include <list>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <ranges>
+#include <set>
+#include <stack>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "DebugUtils.hpp"
+
+
+
+int main( int argc, char** )
+{
+    std::vector<int> v( 100 + argc );
+    std::iota( v.begin(), v.end(), argc );
+    std::vector<std::vector<double>> m( 10, std::vector<double>( 12, 0.5 * argc ) );
+    std::map<std::string, std::vector<int>> mv{ { "one", { 1 } }, { "two", { 2, 2 } } };
+    std::deque<std::pair<int, std::string>> dq{ { 1, "a" }, { 2, "b" } };
+    std::list<std::tuple<int, char, double>> lt{ { 1, 'x', 1.5 }, { argc, 'y', 2.5 } };
+    std::forward_list<long> fl{ 3, 1, 4, 1, 5 };
+    std::set<std::string> ss{ "alpha", "beta" };
+    std::stack<int> st;
+    std::priority_queue<int> pq;
+    std::queue<std::string> q;
+    std::array<int, 4> ar{ 1, 2, 3, argc };
+    int raw[8]{};
+    int raw2[3][3]{};
+
+    long total{ 0 };
+    for ( int i = 0; i < 1000 * argc; i++ )
+    {
+        v[i % v.size()] += i;
+        st.push( i );
+        pq.push( i % 17 );
+        total += v[i % v.size()];
+        debugV( i, total );
+        debugV( v );
+        debugCondV( i % 100 == 0, v, m );
+    }
+    q.push( "queued" );
+    raw[argc] = argc;
+    raw2[argc][argc] = argc;
+
+    debugV( m );
+    debugV( mv, dq );
+    debugV( lt, fl );
+    debugV( ss, st, pq, q );
+    debugV( ar );
+    debugV( v | std::views::filter( []( int x ) { return x % 2; } ) );
+    debugV( std::views::iota( 0 ) );
+    debugArr( raw, 8 );
+    debugArr( raw2, 3 );
+    debugM( "Containers done" );
+
+    std::cout << total << ' ' << v[argc] << ' ' << m[1][1] << ' ' << st.size() << ' ' << pq.top() << ' ' << raw[1] + raw2[1][1] << std::endl;
+}
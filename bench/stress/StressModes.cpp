@@ -0,0 +1,76 @@
+// Stress translation unit for the zero overhead verification:  log levels, categories, conditional,
+// diff, dedup, rate limited and sampled debugging, watchpoints, backtrace mode, and runtime switches.  Debugging calls must each fit on one 
+// line (see VerifyZeroOverhead.cmake).
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "DebugUtils.hpp"
+
+
+
+namespace stress
+{
+    struct Network {};
+    struct Storage {};
+    struct Parser {};
+
+    std::false_type debugCategoryPolicy( Storage );
+}
+
+
+
+int main( int argc, char** argv )
+{
+    std::vector<int> history;
+    std::string name{ argv[0] };
+    bool verbose = argc > 2;
+    double acc{ 0 };
+
+    DebugUtils::disableSites( { .category = "stress::Parser" } );
+    DebugUtils::enableSites( { .file = "stress/*.cpp", .firstLine = 30, .lastLine = 60 }, argc > 3 );
+    DebugUtils::applyFilter( argc > 4 ? argv[4] : "stress/*.cpp:info,-cat=stress::Network" );
+    DebugUtils::enableBacktrace( argc > 5 ? 64 : 0 );
+
+    for ( int i = 0; i < 10000 * argc; i++ )
+    {
+        acc += i * 0.5;
+        if ( i % 1000 == 0 )
+            history.push_back( i );
+
+        debugLevelV( Trace, i, acc );
+        debugLevelV( Info, history );
+        debugLevelM( Warn, "warning level message" );
+        debugLevelV( Error, i, name );
+        debugCatV( stress::Network, i );
+        debugCatV( stress::Storage, history );
+        debugCatM( stress::Parser, "parser message" );
+        debugCondV( verbose, i, acc, history );
+        debugCondM( verbose, "conditional message" );
+        debugDiffV( history );
+        debugDedupV( history.size() );
+        debugRateV( 100, 10, i, acc );
+        debugRateM( 1, 1, "rate limited message" );
+        debugFirstNV( 3, i, name );
+        debugEveryNV( 1000, i, acc );
+        debugEveryTM( std::chrono::milliseconds( 10 ), "sampled message" );
+        debugOnChange( history.size() );
+        debugWatch( acc, []( double a ) { return a > 1e6; } );
+    }
+
+    debugLevelArr( Info, argv, argc );
+    debugCatArr( stress::Network, argv, argc );
+    debugCondArr( verbose, argv, argc );
+    debugRateArr( 10, 1, argv, argc );
+    debugFirstNArr( 1, argv, argc );
+    debugEveryNArr( 2, argv, argc );
+    debugEveryTArr( std::chrono::seconds( 1 ), argv, argc );
+    debugFirstNM( 1, "first message" );
+    debugEveryNM( 2, "every other message" );
+    DebugUtils::flushBacktrace();
+
+    std::cout << acc << ' ' << history.size() << std::endl;
+}
@@ -0,0 +1,61 @@
+// Stress translation unit for the zero overhead verification:  a program that doesn't use iostreams.  
+// With DEBUGUTILS_ON=0 DebugUtils must not bring in the iostreams (and their std::ios_base::Init static 
+// initializer).  Some arguments have side effects, which DEBUGUTILS_ON=0 must not evaluate either.  
+// Debugging calls must each fit on one line (see VerifyZeroOverhead.cmake).
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "DebugUtils.hpp"
+
+
+
+namespace stress
+{
+    struct Codec {};
+
+    // Arguments the compiler can't remove, because they print
+    const char* logName()
+    {
+        std::puts( "opening the log" );
+        return "StressNoStreams";
+    }
+
+    unsigned traced( unsigned value )
+    {
+        std::printf( "traced %u\n", value );
+        return value;
+    }
+}
+
+
+
+int main( int argc, char** argv )
+{
+    logDebugToFile( stress::logName() );
+
+    std::vector<unsigned> codes;
+    std::string text{ argv[0] };
+    unsigned checksum{ 0 };
+
+    for ( char c : text )
+    {
+        checksum = checksum * 31 + static_cast<unsigned char>( c );
+        codes.push_back( checksum );
+        debugV( c, checksum );
+        debugLevelV( Trace, codes.size() );
+        debugCatV( stress::Codec, checksum );
+        debugCondV( argc > 2, codes );
+        debugDiffV( codes );
+        debugDedupV( checksum & 0xff );
+        debugCondV( argc > 3, stress::traced( checksum ) );
+        debugEveryNV( 16, stress::traced( checksum ), codes.back() );
+    }
+
+    debugM( "encoded" );
+    debugArr( argv, argc );
+    debugV( stress::traced( checksum ) );
+
+    std::printf( "%u %zu\n", checksum, codes.size() );
+}
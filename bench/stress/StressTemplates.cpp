@@ -0,0 +1,81 @@
+// Stress translation unit for the zero overhead verification:  debugging calls inside inline functions,
+// function templates (with many instantiations), class templates and lambdas.  Debugging calls must each 
+// fit on one line (see VerifyZeroOverhead.cmake).
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DebugUtils.hpp"
+
+
+
+template <typename T>
+T accumulate( const std::vector<T>& values )
+{
+    T sum{};
+    for ( const auto& x : values )
+    {
+        sum += x;
+        debugV( x, sum );
+    }
+    debugLevelV( Info, values );
+    return sum;
+}
+
+
+template <typename K, typename V>
+class Table
+{
+    public:
+        void put( const K& k, const V& v )
+        {
+            mData[k] = v;
+            debugV( k, v, mData );
+        }
+
+        V get( const K& k ) const
+        {
+            debugDedupV( k );
+            auto it = mData.find( k );
+            return it == mData.end() ? V{} : it->second;
+        }
+
+    private:
+        std::map<K, V> mData;
+};
+
+
+inline int twice( int x )
+{
+    debugM( "twice" );
+    return 2 * x;
+}
+
+
+int main( int argc, char** )
+{
+    std::vector<int> vi( 50, argc );
+    std::vector<long> vl( 60, argc );
+    std::vector<double> vd( 70, argc * 0.25 );
+    std::vector<std::string> vs( 5, "s" );
+
+    Table<int, std::string> t1;
+    Table<std::string, double> t2;
+    for ( int i = 0; i < 100 * argc; i++ )
+    {
+        t1.put( i % 7, std::to_string( i ) );
+        t2.put( std::to_string( i % 5 ), i * 1.5 );
+    }
+
+    auto lambda = [&]( int k ) 
+    { 
+        debugV( k, vi ); 
+        return twice( k ) + static_cast<int>( vi.size() ); 
+    };
+
+    std::cout << accumulate( vi ) << ' ' << accumulate( vl ) << ' ' << accumulate( vd ) << ' ' << accumulate( vs ) << ' '
+              << t1.get( argc ) << ' ' << t2.get( "1" ) << ' ' << lambda( argc ) << std::endl;
+}
@@ -8,6 +8,19 @@
 
 
 
+// Debugging categories, each with its own policy.  Parser follows DEBUGUTILS_ON because it declares no 
+// policy; Sockets is always off.  Declaring std::true_type instead would turn Sockets on even when 
+// DEBUGUTILS_ON=0.
+namespace demo
+{
+    struct Parser {};
+    struct Sockets {};
+
+    std::false_type debugCategoryPolicy( Sockets );
+}
+
+
+
 
 
 int main( int, char** )
@@ -44,14 +57,49 @@ int main( int, char** )
     debugV( ex4 );
     debugV( ex1, ex3 );
 
+    const char* noName{ nullptr };
+    debugV( noName );                       // A null C string prints as nullptr
+
     std::vector<int> v;
     for ( auto i = 1; i <= 3; i++ )
     {
         v.push_back( i * i );
         debugV( i, v );
+        debugDiffV( i, v );                 // Only prints what changed since the previous iteration
     }
     debugV( v );
 
+    // Watchpoints only output a record on the first hit and when the variable changes, or the predicate flips
+    auto total{ 0 };
+    for ( auto i = 0; i < 1000; i++ )
+    {
+        total += i % 7;
+        debugOnChange( total / 1000 );
+        debugWatch( total, []( int t ) { return t > 2500; } );
+    }
+
+    // Only the first of these identical records is output, the rest are counted and reported at the end
+    for ( auto i = 0; i < 5; i++ )
+    {
+        debugDedupV( v );
+    }
+
+    // Consecutive identical records are collapsed:  the first is output, then "repeated 4 times over ... ms"
+    for ( auto i = 0; i < 5; i++ )
+    {
+        debugM( "Retrying the connection" );
+    }
+
+    // Log level debugging (only levels at or above DEBUGUTILS_LEVEL generate code)
+    debugLevelM( Trace, "This is a trace level message" );
+    debugLevelV( Info, ex3 );
+    // End log level debugging examples
+
+    // Category debugging (these are on or off according to their category)
+    debugCatM( demo::Parser, "This category follows DEBUGUTILS_ON" );
+    debugCatV( demo::Sockets, ex2 );
+    // End category debugging examples
+
     // Conditional debugging stuff (change to false to turn off the following debug statements)
     auto includeThisDebug{ true };
 
@@ -64,4 +112,5 @@ int main( int, char** )
 
     // Make sure compiler doesn't strip out loop above when optimizing
     std::cout << "v[1]: " << v[1] << std::endl;
+    std::cout << "total: " << total << std::endl;
 }